@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "dd_buildable.h"
@@ -26,6 +27,16 @@ class bdd_container : public virtual dd_buildable {
     // the oth entry is always the main bdd
     std::vector<DdNode *> m_root_nodes;
 
+    // returns the referenced conjunction of the literals
+    DdNode *compute_cube(std::vector<int> &literals);
+    // helpers for count_weighted_solutions. The level of a constant is the number of variables
+    int node_level(DdNode *node);
+    // product of the total weights of the levels strictly between the parent and the child
+    double skipped_weight(int parent_level, int child_level, std::vector<double> &level_weights);
+    // weighted count of the (possibly complemented) node over the variables at its level and below
+    double weighted_count(DdNode *node, std::vector<double> &level_weights, std::vector<double> &weights,
+                          std::unordered_map<DdNode *, double> &cache);
+
    public:
     // constructor for bdd manager. The number of used variables should be clear from the start
     // this is important for counting the number of solutions and variable ordering
@@ -38,6 +49,9 @@ class bdd_container : public virtual dd_buildable {
     bool is_constant_false(int bdd_index);
     double count_num_solutions(int dd_index);
     double count_num_solutions(int dd_index, int nvars);
+    // counts the solutions where every true variable v contributes the factor weights[v] (1 if v is out of range)
+    // a false variable contributes the factor 1. With all weights 1 this is count_num_solutions
+    double count_weighted_solutions(int dd_index, std::vector<double> &weights);
 
 
     // frees all the nodes under this bdd
@@ -46,8 +60,16 @@ class bdd_container : public virtual dd_buildable {
     void add_clause_primitive(std::vector<int> &clause, int dd_index = 0);
     // adds an exact one constraint to the root node
     void add_exactly_one_primitive(std::vector<int> &variables, int dd_index = 0);
+    // adds an at most one constraint to the root node. The constraint is built directly (2 nodes per literal)
+    void add_at_most_one_primitive(std::vector<int> &literals, int dd_index = 0);
     // adds a dnf to the bdd. it has the form 'g or (a^b^c) or (x^y)'
     void add_dnf_primitive(std::vector<std::vector<int>> &dnf, int dd_index = 0);
+    // adds the implication (a^b^c) -> (x^y^z). Both sides are built as cubes, so it is a single ite and conjoin
+    void add_implication_primitive(std::vector<int> &antecedent, std::vector<int> &consequent, int dd_index = 0);
+    // adds a conjunction of dnfs, dnf i has the terms dnf_offsets[i] to dnf_offsets[i + 1] - 1
+    // used for all frame axioms of a variable. The dnfs are conjoined bottom up in the variable order
+    void add_transition_primitive(std::vector<std::vector<int>> &terms, std::vector<int> &dnf_offsets,
+                                  int dd_index = 0);
 
     void create_ith_var(int i);
 
@@ -94,9 +116,9 @@ class bdd_container : public virtual dd_buildable {
 
     // returns the variable order for timesetep 0 as used by the sub manager
     // maps var idx -> layer in bdd (there are no gaps in the layers)
-    std::map<int, int> get_variable_order_for_single_step(std::map<planning_logic::tagged_variable, int> &variable_map);
+    std::map<int, int> get_variable_order_for_single_step(planning_logic::plan_to_cnf_map &symbol_map);
     // extends the variable order for timestep 0 to all timesteps
-    std::vector<int> extend_variable_order_to_all_steps(std::map<planning_logic::tagged_variable, int> &variable_map,
+    std::vector<int> extend_variable_order_to_all_steps(planning_logic::plan_to_cnf_map &symbol_map,
                                                         std::map<int, int> &single_step_order);
 
    // proof of concepts for queries on bdds
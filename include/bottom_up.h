@@ -2,7 +2,7 @@
 
 #include <vector>
 
-#include "logic_primitive.h"
+#include "primitive_store.h"
 
 namespace conjoin_order {
 
@@ -12,6 +12,7 @@ namespace conjoin_order {
 // second: sort by the number of affected vars (less affected vars come first)
 // then: sort is NOT stable
 //TODO: check if the order is actually correct
-void sort_bottom_up(std::vector<planning_logic::logic_primitive> &primitives, int start, int end,
+// the primitives are given by their ids in the store
+void sort_bottom_up(planning_logic::primitive_store &store, std::vector<int> &primitive_ids, int start, int end,
                     const std::vector<int> &variable_order);
 };
\ No newline at end of file
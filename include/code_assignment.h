@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "sas_parser.h"
+
+namespace code_assignment {
+
+// The codes of the binary encoding for the operators and the values of every variable.
+// A table has 2^bits entries: the first entries are the codes of the operators (values), the remaining entries are
+// the unused codes. An empty table stands for the plain assignment, where the code of index i is i.
+struct binary_codes {
+    std::vector<int> m_op_codes;
+    std::vector<std::vector<int>> m_var_codes;
+};
+
+// reflected gray code of i. Consecutive indices get codes that differ in one bit
+inline int gray_code(int i) { return i ^ (i >> 1); }
+
+// assigns the codes with the given strategy
+// plain: codes in index order
+// gray: gray codes in index order
+// cluster: gray codes in an order where similar operators (same changed variables, then same values) and values that
+// are connected in the domain transition graph follow each other
+binary_codes assign_codes(sas_problem &problem, const std::string &strategy);
+
+bool is_valid_strategy(const std::string &strategy);
+}  // namespace code_assignment
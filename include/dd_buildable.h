@@ -23,8 +23,17 @@ class dd_buildable {
     virtual void add_clause_primitive(std::vector<int> &clause, int dd_index = 0) = 0;
     // adds an exact one constraint to the root node
     virtual void add_exactly_one_primitive(std::vector<int> &variables, int dd_index = 0) = 0;
+    // adds an at most one constraint over the literals to the root node
+    virtual void add_at_most_one_primitive(std::vector<int> &literals, int dd_index = 0) = 0;
     // adds a dnf to the bdd. it has the form 'g or (a^b^c) or (x^y)'
     virtual void add_dnf_primitive(std::vector<std::vector<int>> &dnf, int dd_index = 0) = 0;
+    // adds the implication (a^b^c) -> (x^y^z) to the root node
+    virtual void add_implication_primitive(std::vector<int> &antecedent, std::vector<int> &consequent,
+                                           int dd_index = 0) = 0;
+    // adds a conjunction of dnfs to the root node. Dnf i consists of the terms dnf_offsets[i] to dnf_offsets[i + 1] - 1
+    // the conjunction is built on its own and conjoined with the root node once
+    virtual void add_transition_primitive(std::vector<std::vector<int>> &terms, std::vector<int> &dnf_offsets,
+                                          int dd_index = 0) = 0;
 
     // creates variables until i variables exist.
     // this is important for variable ordering
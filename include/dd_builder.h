@@ -35,6 +35,11 @@ void construct_dd_by_layer_exponentially(dd_buildable &container, encoder::encod
 // can be turned silent
 void conjoin_primitives_linear(dd_buildable &dd, std::vector<planning_logic::logic_primitive> &logic_primitives,
                                int dd_index = 0, bool silent = false);
+// conjoins a single logic primitive to the given bdd
+void conjoin_primitive(dd_buildable &dd, planning_logic::logic_primitive &primitive, int dd_index);
+// conjoins the primitives of the stream while they are produced
+void conjoin_primitive_stream(dd_buildable &dd, conjoin_order::primitive_stream &stream, int dd_index = 0,
+                              bool silent = false);
 // checks if goal is fullfilled in the given timestep
 bool goal_is_fullfilled(dd_buildable &container, encoder::encoder_abstract &encoder, int main_idx, int temp_idx,
                         int timestep);
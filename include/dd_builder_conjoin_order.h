@@ -7,6 +7,7 @@
 #include "encoder_basic.h"
 #include "logic_primitive.h"
 #include "options.h"
+#include "primitive_store.h"
 
 namespace conjoin_order {
 
@@ -21,15 +22,22 @@ std::vector<planning_logic::logic_primitive> order_all_clauses(encoder::encoder_
                                                                option_values &options);
 
 // helper methods to order logic primitives. The correct ordering method will be used by order_all_clauses
-std::vector<std::tuple<planning_logic::logic_primitive, int>> create_force_clause_order_mapping(
-    encoder::encoder_abstract &encoder, option_values &options);
-std::vector<std::tuple<planning_logic::logic_primitive, int>> create_custom_clause_order_mapping(
-    encoder::encoder_abstract &encoder, option_values &options);
-std::vector<std::tuple<planning_logic::logic_primitive, int>> create_bottom_up_clause_order_mapping(
-    encoder::encoder_abstract &encoder, option_values &options);
-std::vector<std::tuple<planning_logic::logic_primitive, int, int>> create_mixed_clause_order_mapping(
-    std::vector<std::tuple<planning_logic::logic_primitive, int>> &order,
-    std::vector<std::tuple<planning_logic::logic_primitive, int>> &tiebreaker);
+// the primitives are added to the store and referenced by their id. The tuples are (primitive id, order)
+std::vector<std::tuple<int, int>> create_force_clause_order_mapping(encoder::encoder_abstract &encoder,
+                                                                    planning_logic::primitive_store &store,
+                                                                    option_values &options);
+std::vector<std::tuple<int, int>> create_custom_clause_order_mapping(encoder::encoder_abstract &encoder,
+                                                                     planning_logic::primitive_store &store,
+                                                                     option_values &options);
+std::vector<std::tuple<int, int>> create_bottom_up_clause_order_mapping(encoder::encoder_abstract &encoder,
+                                                                        planning_logic::primitive_store &store,
+                                                                        option_values &options);
+// the (tag, timestep) pairs of the custom build order. key_order is filled with their position in the partial order
+std::vector<std::tuple<planning_logic::primitive_tag, int>> create_custom_order_keys(option_values &options,
+                                                                                     std::vector<int> &key_order);
+std::vector<std::tuple<int, int, int>> create_mixed_clause_order_mapping(std::vector<std::tuple<int, int>> &order,
+                                                                         std::vector<std::tuple<int, int>> &tiebreaker,
+                                                                         int num_primitives);
 
 // same as order clauses but only orders the precondition, effect and frame clauses for timeset 0
 std::vector<planning_logic::logic_primitive> order_clauses_for_layer(encoder::encoder_abstract &encoder,
@@ -39,6 +47,23 @@ std::vector<planning_logic::logic_primitive> order_clauses_for_layer(encoder::en
 std::vector<planning_logic::logic_primitive> order_clauses_for_foundation(encoder::encoder_abstract &encoder,
                                                                           std::string &order_string, int timesteps);
 
+// yields the primitives of the custom build order one (tag, timestep) pair at a time.
+// The primitives are not kept in the cache of the encoder, so only the current pair is in memory
+class primitive_stream {
+   private:
+    encoder::encoder_abstract &m_encoder;
+    std::vector<std::tuple<planning_logic::primitive_tag, int>> m_keys;
+    int m_next = 0;
+
+   public:
+    primitive_stream(encoder::encoder_abstract &encoder, option_values &options);
+
+    // replaces primitives by the primitives of the next pair. Returns false if all pairs were taken
+    bool next(std::vector<planning_logic::logic_primitive> &primitives);
+    int num_pairs() { return m_keys.size(); }
+    int num_taken() { return m_next; }
+};
+
 // helper methods:
 // find the primitives of all timesteps for a given primitive type. ordered by timesteps ascending
 std::vector<planning_logic::logic_primitive> collect_primitives_for_all_timesteps(
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include "code_assignment.h"
 #include "logic_primitive.h"
 #include "plan_to_cnf_map.h"
 #include "sas_parser.h"
@@ -15,7 +20,70 @@ class encoder_abstract {
     // constructs the logic primitives according to the tag and timestep
     // will change the symbol map if new variables are created
     encoder_abstract(option_values &options, sas_problem &problem, int num_operators)
-        : m_options(options), m_sas_problem(problem), m_symbol_map(num_operators) {}
+        : m_options(options), m_sas_problem(problem), m_symbol_map(num_operators) {
+        // the binary parallel encoding always encodes the state variables binary
+        m_binary_variables =
+            std::vector<bool>(problem.m_variabels.size(), options.binary_variables || options.binary_parallel);
+        if (options.adaptive_encoding) {
+            choose_variable_encodings();
+        }
+        if (options.reachability_pruning) {
+            set_up_reachability_pruning();
+        }
+        if (options.binary_code_assignment != "plain") {
+            code_assignment::binary_codes codes = code_assignment::assign_codes(m_sas_problem, options.binary_code_assignment);
+            m_symbol_map.set_binary_codes(codes.m_op_codes, codes.m_var_codes);
+        }
+    }
+
+    // variables of facts and operators that can not be part of a plan are not created
+    // the primitives are simplified, as if these variables were false
+    void set_up_reachability_pruning();
+
+    // chooses the binary or unary encoding for every variable with a cost model of one timestep:
+    // a unary variable needs one bdd variable per value, an at most one constraint and one literal per occurrence
+    // a binary variable needs log(values) bdd variables, excludes the unused codes and one literal per bit for
+    // every occurrence. Both need one frame axiom per value, which contains the variable twice
+    void choose_variable_encodings();
+
+    // constructs the logic primitives according to the tag and timestep without using the cache
+    // will change the symbol map if new variables are created
+    virtual std::vector<planning_logic::logic_primitive> construct_logic_primitives(planning_logic::primitive_tag tag,
+                                                                                    int timestep) = 0;
+    // returns true, if the primitives of a tag only differ in the timestep of their variables
+    // the primitives of these tags are only constructed once and then shifted to other timesteps
+    virtual bool is_timestep_invariant(planning_logic::primitive_tag tag);
+
+    // combines the frame primitives (one for every variable value pair, ordered by variable and value)
+    // into one transition primitive per variable
+    std::vector<planning_logic::logic_primitive> combine_frame_to_transitions(
+        const std::vector<planning_logic::logic_primitive> &frame_primitives, int timestep);
+
+   private:
+    // m_binary_variables[var] is true if the values of var are encoded binary
+    std::vector<bool> m_binary_variables;
+
+    // the primitives of one timestep of a timestep invariant tag
+    // the variables of the primitives are replaced by local ids (1 based, in the order of their first occurrence)
+    struct primitive_template {
+        int m_timestep;
+        // cnf index of every local id at m_timestep (index 0 is unused)
+        std::vector<int> m_variables;
+        std::vector<planning_logic::logic_primitive> m_local_primitives;
+    };
+
+    // already constructed primitives for (tag, timestep)
+    std::map<std::tuple<planning_logic::primitive_tag, int>, std::vector<planning_logic::logic_primitive>>
+        m_primitive_cache;
+    std::map<planning_logic::primitive_tag, primitive_template> m_templates;
+
+    primitive_template create_template(const std::vector<planning_logic::logic_primitive> &primitives, int timestep);
+    // returns the cnf index of every local id of the template shifted by t_diff timesteps
+    // creates the variables that do not exist yet in the order of their first occurrence
+    std::vector<int> reserve_shifted_variables(const primitive_template &primitive_template, int t_diff);
+    // replaces the local ids of the template by the given variables. Does not access the symbol map
+    static std::vector<planning_logic::logic_primitive> instantiate_template(
+        const primitive_template &primitive_template, const std::vector<int> &variables, int t_diff);
 
    public:
     // represents the planning problem
@@ -25,14 +93,23 @@ class encoder_abstract {
 
     virtual ~encoder_abstract(){};
 
+    bool is_binary_variable(int var) { return m_binary_variables[var]; }
+
     // calculates the number of variables in the first t timesteps
     virtual int num_variables_in_t_timesteps(int t) = 0;
     // creates a disjunction of all goals in the first t timesteps
     virtual std::vector<planning_logic::logic_primitive> prebuild_goals(int t) = 0;
 
-    // constructs the logic primitives according to the tag and timestep
+    // returns the logic primitives according to the tag and timestep
     // will change the symbol map if new variables are created
-    virtual std::vector<planning_logic::logic_primitive> get_logic_primitives(planning_logic::primitive_tag tag,
-                                                                              int timestep) = 0;
+    // the result is cached. For timestep invariant tags it is derived from the template of another timestep
+    std::vector<planning_logic::logic_primitive> get_logic_primitives(planning_logic::primitive_tag tag, int timestep);
+    // fills the cache for all (tag, timestep) pairs. The result is the same as calling get_logic_primitives for the
+    // pairs in the given order, but the shifting of the templates is done with num_threads threads
+    void prepare_logic_primitives(const std::vector<std::tuple<planning_logic::primitive_tag, int>> &keys);
+    // same as get_logic_primitives, but the primitives are not kept in the cache
+    std::vector<planning_logic::logic_primitive> take_logic_primitives(planning_logic::primitive_tag tag, int timestep);
+    // frees the cached primitives. The templates are kept
+    void clear_primitive_cache();
 };
 }  // namespace encoder
\ No newline at end of file
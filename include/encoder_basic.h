@@ -12,10 +12,15 @@ namespace encoder {
 class encoder_basic : public virtual encoder_abstract {
    public:
     encoder_basic(option_values &options, sas_problem &problem)
-        : encoder_abstract(options, problem, problem.m_operators.size()) {}
+        : encoder_abstract(options, problem, problem.m_operators.size()) {
+        if (options.commutation_reduction) {
+            graph::undirected_graph commutation_graph = m_sas_problem.construct_action_commutation_graph();
+            for (int op = 0; op < commutation_graph.get_num_nodes(); op++) {
+                m_commuting_operators.push_back(commutation_graph.get_neighbours(op));
+            }
+        }
+    }
 
-    std::vector<planning_logic::logic_primitive> get_logic_primitives(planning_logic::primitive_tag tag, int timestep);
-    
     // returns the number of variables that occur in t timesteps
     // these include the var and operator variables, but not the operator variables for the last timestep
     int num_variables_in_t_timesteps(int t);
@@ -39,11 +44,13 @@ class encoder_basic : public virtual encoder_abstract {
     // compares two asssignments for a cnf formula and prints the difference in human readable form (for debugging)
     void compare_assignments(std::vector<bool> &assignment1, std::vector<bool> &assignment2);
 
+   protected:
+    std::vector<planning_logic::logic_primitive> construct_logic_primitives(planning_logic::primitive_tag tag,
+                                                                            int timestep);
+
    private:
-    // keeps track of the maximum timestep that was encoded
-    int m_num_timesteps;
-    // increases num_timesteps to the new maximum
-    void update_timesteps(int timestep);
+    // neighbours of every operator in the commutation graph. Only used for commutation_reduction
+    std::vector<std::vector<int>> m_commuting_operators;
 
     // These methods generate all the logic primitives that represent the planning problem
     std::vector<planning_logic::logic_primitive> construct_initial_state();
@@ -53,6 +60,8 @@ class encoder_basic : public virtual encoder_abstract {
     std::vector<planning_logic::logic_primitive> construct_mutex(int timestep);
     std::vector<planning_logic::logic_primitive> construct_precondition(int timestep);
     std::vector<planning_logic::logic_primitive> construct_effect(int timestep);
+    // one implication op -> (pre(op) ^ eff(op)) per operator. Used for group_pre_eff
+    std::vector<planning_logic::logic_primitive> construct_grouped_precondition_effect(int timestep);
     std::vector<planning_logic::logic_primitive> construct_frame(int timestep);
 
     // generates a set of clauses that gurarantee that at most on of the variables is true
@@ -69,5 +78,13 @@ class encoder_basic : public virtual encoder_abstract {
     std::vector<std::vector<int>> generate_at_most_one_constraint_pairwise(std::vector<int> &variables);
 
     std::vector<planning_logic::logic_primitive> construct_no_conflicting_operators(int timestep);
+    // two commuting operators may only follow each other in the order of their indices
+    // op2(t) -> !op1(t-1) for every commuting op1 > op2
+    // this reduces the number of plans, but the implications can make the dd larger (gripper grows by about 7%)
+    std::vector<planning_logic::logic_primitive> construct_commutation_order(int timestep);
+    // the objects of every symmetric class have to be touched for the first time in their order
+    // h(t+1, c, i) <-> h(t, c, i) v op(t) for the operators touching object i of class c
+    // op(t) -> h(t, c, i-1) for the operators touching object i
+    std::vector<planning_logic::logic_primitive> construct_symmetry_breaking(int timestep);
 };
 }  // namespace encoder
\ No newline at end of file
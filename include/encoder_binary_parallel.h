@@ -14,15 +14,16 @@ class binary_parallel : public virtual encoder_abstract {
 
     int num_variables_in_t_timesteps(int t);
     std::vector<planning_logic::logic_primitive> prebuild_goals(int t);
-    // constructs the logic primitives according to the tag and timestep
-    // will change the symbol map if new variables are created
-    std::vector<planning_logic::logic_primitive> get_logic_primitives(planning_logic::primitive_tag tag, int timestep);
+
+    int num_colours() { return m_num_colours; }
+    // number of operators of the colour class, including the noop
+    int colour_class_size(int colour) { return m_colour_class_size[colour]; }
+
+   protected:
+    std::vector<planning_logic::logic_primitive> construct_logic_primitives(planning_logic::primitive_tag tag,
+                                                                            int timestep);
 
    private:
-    // keeps track of the maximum timestep that was encoded
-    int m_num_timesteps;
-    // increases num_timesteps to the new maximum
-    void update_timesteps(int timestep);
 
     // colouring of the complement of the graph above
     std::vector<int> m_colouring;
@@ -41,6 +42,8 @@ class binary_parallel : public virtual encoder_abstract {
     std::vector<planning_logic::logic_primitive> construct_mutex(int timestep);
     std::vector<planning_logic::logic_primitive> construct_precondition(int timestep);
     std::vector<planning_logic::logic_primitive> construct_effect(int timestep);
+    // one implication op -> (pre(op) ^ eff(op)) per operator. Used for group_pre_eff
+    std::vector<planning_logic::logic_primitive> construct_grouped_precondition_effect(int timestep);
     std::vector<planning_logic::logic_primitive> construct_frame(int timestep);
 };
 }  // namespace encoder
\ No newline at end of file
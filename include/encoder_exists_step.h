@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+
+#include "encoder_basic.h"
+
+namespace encoder {
+
+// Encoder for exists step plans: a timestep may contain several operators, if all of their preconditions hold at the
+// start of the step and they can be applied in the order of their indices, i.e. no operator deletes a precondition
+// of an operator with a higher index in the same step.
+// Every model is a step plan (a sequence of sets of operators, steps may be empty). The number of models counts step
+// plans, not the sequential plans that can be derived from them.
+// All other primitives are the ones of the basic encoder.
+class encoder_exists_step : public encoder_basic {
+   public:
+    encoder_exists_step(option_values &options, sas_problem &problem)
+        : encoder_abstract(options, problem, problem.m_operators.size()), encoder_basic(options, problem) {}
+
+   protected:
+    std::vector<planning_logic::logic_primitive> construct_logic_primitives(planning_logic::primitive_tag tag,
+                                                                            int timestep);
+
+   private:
+    // op(t) -> post(t+1) for every effect that changes a variable
+    // prevail conditions are no effects, otherwise an operator that changes the variable later in the step would
+    // contradict them
+    std::vector<planning_logic::logic_primitive> construct_exists_step_effects(int timestep);
+    // one chain per fact: if an operator that deletes the fact is part of the step, no operator with a higher index
+    // that needs the fact can be part of it. The chains use helper variables, so the encoding is linear in the size
+    // of the problem
+    std::vector<planning_logic::logic_primitive> construct_exists_step_chains(int timestep);
+};
+}  // namespace encoder
@@ -1,23 +1,69 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
-#include "logic_primitive.h"
+#include "options.h"
+#include "primitive_store.h"
 
 namespace variable_order {
 
+// how many force instances are run and how their initial orders are chosen
+struct force_parameters {
+    int m_num_starts;
+    int m_num_threads;
+    unsigned int m_seed;
+    // if false, the first start uses the given initial order and only the other starts shuffle it
+    bool m_shuffle_all;
+
+    // a negative force_seed is replaced by a random seed
+    force_parameters(option_values &options);
+};
+
 // returns a variable order (pos to idx) given a set of logic primitives.
 // the given primitives should not include indizes of variables not included in the initial order
-std::vector<int> force_variable_order(std::vector<int> &initial_pos_to_idx,
-                                      std::vector<planning_logic::logic_primitive> &primitives);
+std::vector<int> force_variable_order(std::vector<int> &initial_pos_to_idx, planning_logic::primitive_store &store,
+                                      std::vector<int> &primitive_ids, force_parameters &parameters);
 
 // returns a vector (pos to clause mapping), the ith entry in the vector indicates, which clause should be conjoined at
 // the ith step
-std::vector<int> force_clause_order(std::vector<int> &initial_pos_to_idx,
-                                    std::vector<planning_logic::logic_primitive> &primitives, int num_variables);
+std::vector<int> force_clause_order(std::vector<int> &initial_pos_to_idx, planning_logic::primitive_store &store,
+                                    std::vector<int> &primitive_ids, int num_variables, force_parameters &parameters);
+
+// hyper edges in compressed sparse row layout
+// the nodes of edge e are m_nodes[m_offsets[e]] to m_nodes[m_offsets[e + 1] - 1]
+struct hypergraph {
+    std::vector<int> m_offsets;
+    std::vector<int> m_nodes;
+
+    int num_edges() const { return m_offsets.size() - 1; }
+};
+
+// how one run of force went
+struct force_statistics {
+    int m_iterations = 0;
+    int64_t m_initial_span = 0;
+    int64_t m_final_span = 0;
+};
+
+// sorts the nodes by their position, ties are broken by the node index. The result is the same as std::sort on the
+// (position, node) pairs, --benchmark_force_sort compares both. The positions may not be negative
+// the buffers only avoid allocations between the calls
+void sort_by_position(std::vector<double> &position, std::vector<int> &sorted_nodes, std::vector<uint32_t> &keys,
+                      std::vector<uint32_t> &key_buffer, std::vector<int> &node_buffer);
 
 // uses the force algorithm to calculate an ordering for this hypergraph
 // position to nodes gives the intial position of the vertices in the ordering
-// returns an optiomized position to node mapping
-std::vector<int> force_algorithm(std::vector<int> &position_to_node, std::vector<std::vector<int>> &hyper_edges);
-};  // namespace variable_order
\ No newline at end of file
+// returns an optiomized position to node mapping. Does not log, so it can run on the threads of a pool
+std::vector<int> force_algorithm(std::vector<int> &position_to_node, hypergraph &graph,
+                                 force_statistics &statistics);
+
+// runs force for every start on a thread pool and returns the order with the lowest total span
+// the initial order of start i is the given order shuffled with the seed + i
+// the statistics of the starts are logged after all of them finished
+std::vector<int> multi_start_force_algorithm(std::vector<int> &position_to_node, hypergraph &graph,
+                                             force_parameters &parameters);
+
+// the span of a hyper edge is the difference between the positions of its lowest and highest node
+int64_t calculate_total_span(std::vector<int> &node_to_pos, hypergraph &graph);
+};  // namespace variable_order
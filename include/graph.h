@@ -1,24 +1,72 @@
 #pragma once
 
-#include <vector>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <utility>
+#include <vector>
+
+class thread_pool;
 
 namespace graph
 {
 
+// view on the sorted neighbours of a node. Stays valid until the next edge is added
+class neighbour_range {
+   public:
+    neighbour_range(const int *begin, const int *end) : m_begin(begin), m_end(end) {}
+
+    const int *begin() const { return m_begin; }
+    const int *end() const { return m_end; }
+    int size() const { return m_end - m_begin; }
+    int operator[](int i) const { return m_begin[i]; }
+
+   private:
+    const int *m_begin, *m_end;
+};
+
+// Graphs with at most dense_node_limit nodes additionally keep an adjacency bitset, which gives
+// constant time are_neighbours and a word parallel complement. All graphs keep their neighbours in a
+// sorted compressed sparse row layout, that is rebuilt lazily after edges were added.
 class undirected_graph {
    public:
-    std::vector<std::vector<int>> m_edge_list;
-    
+    static const int dense_node_limit = 1 << 14;
+
     undirected_graph(int num_nodes);
 
+    // adding an edge twice has no effect
     void add_edge(int nodeA, int nodeB);
+    // replaces all edges. find_neighbours(node, neighbours) has to fill in the sorted neighbours of the node
+    // and the result has to be symmetric. The nodes are distributed over the threads of the pool
+    void set_all_neighbours(thread_pool &pool, const std::function<void(int, std::vector<int> &)> &find_neighbours);
 
     int get_num_nodes();
+    int get_num_edges();
     bool are_neighbours(int nodeA, int nodeB);
+    // copies the neighbours, use neighbours to iterate over them
     std::vector<int> get_neighbours(int node);
+    neighbour_range neighbours(int node);
 
     undirected_graph construct_complement();
+
+   private:
+    int m_num_nodes;
+    bool m_is_dense;
+
+    // m_bits[node * m_num_words + (other / 64)] has bit (other % 64) set for every neighbour. Only if dense
+    int m_num_words;
+    std::vector<uint64_t> m_bits;
+
+    // false if edges were added since the last compression
+    bool m_is_compressed = true;
+    // edges added since the last compression. Only used if not dense, otherwise the bitset is compressed
+    std::vector<std::pair<int, int>> m_new_edges;
+    // the neighbours of node are m_targets[m_offsets[node]] to m_targets[m_offsets[node + 1] - 1]
+    std::vector<int> m_offsets;
+    std::vector<int> m_targets;
+
+    // merges the new edges into the sorted and duplicate free neighbour lists
+    void compress();
 };
 
 void write_to_file(std::string filepath, undirected_graph &graph);
@@ -28,4 +76,13 @@ void write_to_file_with_colouring(std::string filepath, undirected_graph &graph,
 // uses greedy colouring to colour graph
 // always colours the node with the most different colours in its neighbourhood
 std::vector<int> approximate_colouring(undirected_graph &graph);
-}
\ No newline at end of file
+
+// the colourings below are implemented in graph_colouring.cpp
+int num_colours(const std::vector<int> &colouring);
+// DSATUR with a bucket queue over the number of different colours in the neighbourhood
+// ties are broken by the degree
+std::vector<int> dsatur_colouring(undirected_graph &graph);
+// starts with DSATUR and improves the colouring with iterated greedy steps and tabu search until
+// time_budget seconds are used. Every improvement is logged together with the time
+std::vector<int> improved_colouring(undirected_graph &graph, double time_budget);
+}
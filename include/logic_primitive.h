@@ -8,6 +8,9 @@ enum logic_primitive_type {
     logic_clause,
     logic_dnf,
     logic_eo,
+    logic_amo,  // at most one of the literals in m_data is true
+    logic_implication,  // m_dnf_data = {antecedent, consequent}: the cube antecedent implies the cube consequent
+    logic_transition,   // conjunction of dnfs. m_dnf_data holds the terms of all dnfs, m_dnf_offsets where they start
 };
 
 enum primitive_tag {
@@ -31,12 +34,17 @@ class logic_primitive {
     int m_timestep;
     std::vector<int> m_data;
     std::vector<std::vector<int>> m_dnf_data;
+    // only for logic_transition: dnf i consists of the terms m_dnf_offsets[i] to m_dnf_offsets[i + 1] - 1
+    std::vector<int> m_dnf_offsets;
 
     logic_primitive(logic_primitive_type type, primitive_tag c_tag, int timesteps, std::vector<int> data)
         : m_type(type), m_clause_tag(c_tag), m_timestep(timesteps), m_data(data) {}
     logic_primitive(logic_primitive_type type, primitive_tag c_tag, int timesteps,
                     std::vector<std::vector<int>> dnf_data)
         : m_type(type), m_clause_tag(c_tag), m_timestep(timesteps), m_dnf_data(dnf_data) {}
+    logic_primitive(logic_primitive_type type, primitive_tag c_tag, int timesteps,
+                    std::vector<std::vector<int>> dnf_data, std::vector<int> dnf_offsets)
+        : m_type(type), m_clause_tag(c_tag), m_timestep(timesteps), m_dnf_data(dnf_data), m_dnf_offsets(dnf_offsets) {}
 
     std::vector<int> get_affected_variables() const;
     std::string to_string();
@@ -8,23 +8,42 @@ struct option_values {
     // Files
     std::string sas_file, ass_file, cnf_file;
     // Program modes
-    bool encode_cnf, cnf_to_bdd, conflict_graph, build_bdd, build_sdd, single_minisat, count_minisat, hack_debug, build_bdd_naiv, build_sdd_naiv;
+    bool encode_cnf, cnf_to_bdd, conflict_graph, build_bdd, build_sdd, single_minisat, count_minisat, hack_debug, build_bdd_naiv, build_sdd_naiv,
+        benchmark_parser, benchmark_conflict_graph, benchmark_force_sort;
+    // number of repetitions for the benchmark modes
+    int benchmark_runs;
+    // number of threads for the parallel parts of the encoding
+    int num_threads;
 
     int timesteps;
     double num_plans, quality_bound;
+    // seconds used to improve the colouring of the operators for binary_parallel
+    double colouring_time_budget;
     // DD building parameters
     std::string build_order, variable_order;
+    // how the codes of the binary encodings are assigned: plain, gray or cluster
+    std::string binary_code_assignment;
     // effects the building algorithm
     bool layer, layer_bi, layer_expo, linear, prebuild_goals, restart, use_fd;
     // reverses the order of primitives (only for linear non incremental)
     bool reverse_order;
+    // simplifies the ordered primitives before the linear build
+    bool preprocess;
+    // the primitives are conjoined while they are encoded, without ordering all of them first
+    bool stream_primitives;
+    // simplifies the sas problem before it is encoded
+    bool simplify_task;
+    // adds the h2 mutexes to the mutex groups of the sas problem
+    bool h2_mutexes;
+    // only creates the variables of facts and operators that can be part of a plan at their timestep
+    bool reachability_pruning;
     // effects the encoding
-    bool include_mutex, use_ladder_encoding, group_pre_eff, exact_one_constraint, parallel_plan, binary_encoding,
-        binary_variables, binary_exclude_impossible, binary_parallel;
+    bool include_mutex, use_ladder_encoding, group_pre_eff, exact_one_constraint, amo_constraint, transition_frame,
+        parallel_plan, exists_step, commutation_reduction, symmetry_breaking, binary_encoding, binary_variables, adaptive_encoding, binary_exclude_impossible, binary_parallel;
     // effects the variable ordering
     bool no_reordering, goal_variables_first, initial_state_variables_first;
     // effects variable_grouping
-    bool group_variables, group_variables_small, group_actions;
+    bool group_variables, group_variables_small, group_actions, group_actions_small;
     // DD layer building
     bool share_foundations, use_layer_permutation, reverse_layer_building;
 
@@ -33,6 +52,8 @@ struct option_values {
     bool clause_order_custom, clause_order_force, clause_order_custom_force;
     bool clause_order_bottom_up, clause_order_custom_bottom_up;
     bool force_random_seed;
+    // number of force instances with different initial orders and the seed of their shuffles
+    int force_num_starts, force_seed;
     bool split_inside_timestep;
 
     // proof of concept queries
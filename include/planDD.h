@@ -17,4 +17,8 @@ int cnf_to_bdd(option_values opt_values);
 
 int single_minisat(option_values opt_values);
 int count_minisat(option_values opt_values);
+
+int benchmark_parser(option_values opt_values);
+int benchmark_conflict_graph(option_values opt_values);
+int benchmark_force_sort(option_values opt_values);
 };
\ No newline at end of file
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <map>
+#include <tuple>
 #include <vector>
 
 namespace planning_logic {
@@ -13,25 +16,64 @@ enum variable_tag {
     variable_h_amost_variable,
     variable_h_amost_operator,
     variable_h_amost_mutex,
+    variable_h_exists_step,  // chain variables of the exists step encoding
+    variable_h_symmetry,     // object of a symmetric class was touched before the timestep
     variable_none,
 };
 
 // variable tag, timestep, index of the variable (and value if it exist, 0 else)
 typedef std::tuple<variable_tag, int, int, int> tagged_variable;
 
+// Information about all variables with the same tag and timestep.
+// If a block was created in one go, its indices are contiguous and a block of another timestep with the same
+// layout can be reached by adding a constant offset.
+struct variable_block {
+    int m_first_index = 0;
+    int m_last_index = 0;
+    int m_size = 0;
+    bool m_is_contiguous = true;
+    // hash over the (var_index, value) pairs in the order they were created
+    // equal hashes only make an offset likely, the shifted variables are still checked
+    uint64_t m_layout_hash = 0;
+};
+
 class plan_to_cnf_map {
    private:
     // how many operators are present and how man variabls are needed to represent them
     int m_num_operators, m_num_op_variables;
 
+    // maps information about planning variable to variable index of cnf formula
+    // m_index_table[tag][timestep][var_index][value] is the cnf index or 0 if the variable does not exist
+    std::vector<std::vector<std::vector<std::vector<int>>>> m_index_table;
+    // m_inverse_variable_map[index] is the planning information of the cnf index
+    // index 0 is the dummy variable and gets the tag variable_none
+    std::vector<tagged_variable> m_inverse_variable_map;
+    // m_blocks[tag][timestep]
+    std::vector<std::vector<variable_block>> m_blocks;
+
+    // variables for which m_is_impossible returns true are not created. They are all mapped to m_false_index
+    std::function<bool(variable_tag, int, int, int)> m_is_impossible;
+    int m_false_index = 0;
+
+    // code of every operator and of every value of every variable in the binary encoding
+    // empty if the code of an index is the index itself
+    std::vector<int> m_op_codes;
+    std::vector<std::vector<int>> m_var_codes;
+
+    // returns a pointer to the entry of the table. Returns nullptr if it does not exist and create is false
+    int *lookup(variable_tag tag, int timestep, int var_index, int value, bool create);
+
+    // the permutation wraps around, state variables live for num_timesteps+1 and operators for num_timesteps steps
+    int permuted_timestep(variable_tag tag, int t, int t_diff, int num_timesteps);
+
+    // true if the two blocks have the same size and hash, so that the variables are probably shifted by an offset
+    bool may_be_offset(variable_block &from, variable_block &to);
+    // true if to_index is the variable from_index with its timestep replaced by t_to
+    bool is_shifted_variable(int from_index, int to_index, int t_to);
+
    public:
     plan_to_cnf_map(int num_operators);
 
-    // maps information about planning variable to variable index of cnf formula
-    // are used by the variable ordering algorithm
-    std::map<tagged_variable, int> m_variable_map;
-    std::map<int, tagged_variable> m_inverse_variable_map;
-
     // calculates the number of bits that is needed to represent this amount of variables in a binary encoding
     // more specifically: calculate the highest bit position or ceil(log2(num_variables))
     int num_bits_for_binary_var(int num_variables);
@@ -64,11 +106,28 @@ class plan_to_cnf_map {
     int get_variable_index_without_adding(variable_tag tag, int timestep, int var_index, int value);
     int get_variable_index_without_adding(variable_tag tag, int timestep, int var_index);
 
+    // the variables for which is_impossible(tag, timestep, var_index, value) returns true are false in every solution
+    // they are not created, but mapped to a single new variable. It has to be forced to be false
+    void set_impossible_variables(std::function<bool(variable_tag, int, int, int)> is_impossible);
+    // sets the codes used by the binary encodings. Every table needs an entry for every code of its bits
+    void set_binary_codes(std::vector<int> op_codes, std::vector<std::vector<int>> var_codes);
+    // the variable all impossible variables are mapped to. 0 if there are no impossible variables
+    int get_false_variable() { return m_false_index; }
+
     // inverse of the methods above
     tagged_variable get_planning_info_for_variable(int index);
 
+    // returns the index of the same variable t_diff timesteps later. Adds the variable if it does not exist
+    // if the blocks of both timesteps have the same layout, this is only an offset
+    int get_shifted_variable_index(int index, int t_diff);
+
+    // returns all variables sorted by (tag, timestep, var_index, value) together with their cnf index
+    // this is the order in which the old map based implementation iterated over the variables
+    std::vector<std::tuple<tagged_variable, int>> get_variables_in_key_order();
+
     // calculates the permutation between two timesteps. All variables have to already be present for this
     // advances the timestep of every variable by t_diff
+    // blocks of variables with the same layout are shifted by a constant offset
     std::vector<int> calculate_permutation_by_timesteps(int t_diff, int num_timesteps);
 
     int get_num_variables();
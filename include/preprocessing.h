@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vector>
+
+#include "logic_primitive.h"
+
+/*
+ * Simplifies the ordered logic primitives before they are conjoined.
+ * All steps keep the formula logically equivalent, so the number of solutions of the dd does not change.
+ */
+namespace preprocessing {
+
+// propagates unit literals, removes satisfied primitives and false literals, removes duplicate and subsumed clauses.
+// the unit literals are kept as clauses at the front of the result (in the order they were found).
+// the relative order of the remaining primitives does not change
+std::vector<planning_logic::logic_primitive> simplify_primitives(
+    std::vector<planning_logic::logic_primitive> &primitives);
+
+// simplifies the primitives under the assumption that the variable is false
+// literals that become fixed are added as unit clauses with the tag and timestep of the primitive they came from
+std::vector<planning_logic::logic_primitive> assign_false(std::vector<planning_logic::logic_primitive> &primitives,
+                                                          int variable);
+}  // namespace preprocessing
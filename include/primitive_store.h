@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "logic_primitive.h"
+
+namespace planning_logic {
+
+// Stores logic primitives in flat arrays (compressed sparse rows).
+// Every distinct primitive gets a stable id. Adding the same primitive (type, tag, timestep and literals) twice
+// returns the same id, so orderings calculated from different calls to the encoder can be combined by id.
+// The sorted support (set of affected variables) of every primitive is calculated once on insertion.
+class primitive_store {
+   private:
+    std::vector<logic_primitive_type> m_types;
+    std::vector<primitive_tag> m_tags;
+    std::vector<int> m_timesteps;
+    std::vector<uint64_t> m_hashes;
+
+    // literals of all primitives. The literals of primitive i are in [m_literal_offsets[i], m_literal_offsets[i+1])
+    // they are split into segments: the first segment is m_data, the following segments are the dnf terms
+    // the end offsets of the segments of primitive i are in m_segment_ends[m_segment_offsets[i]...]
+    std::vector<int> m_literals;
+    std::vector<int> m_literal_offsets;
+    std::vector<int> m_segment_ends;
+    std::vector<int> m_segment_offsets;
+    // the dnf offsets of the transitions. Those of primitive i are in [m_dnf_bound_offsets[i], m_dnf_bound_offsets[i+1])
+    std::vector<int> m_dnf_bounds;
+    std::vector<int> m_dnf_bound_offsets;
+
+    // sorted absolute variable indices of every primitive
+    std::vector<int> m_support;
+    std::vector<int> m_support_offsets;
+
+    // hash -> ids with this hash
+    std::unordered_multimap<uint64_t, int> m_lookup;
+
+    // returns true if the primitive with the given id is the same as the one given
+    bool is_equal(int id, const logic_primitive &primitive);
+
+   public:
+    primitive_store();
+
+    // adds the primitive and returns its id. Returns the id of an equal primitive if one was added before
+    int add_primitive(const logic_primitive &primitive);
+    std::vector<int> add_primitives(const std::vector<logic_primitive> &primitives);
+
+    int size() { return m_types.size(); }
+
+    logic_primitive_type get_type(int id) { return m_types[id]; }
+    primitive_tag get_tag(int id) { return m_tags[id]; }
+    int get_timestep(int id) { return m_timesteps[id]; }
+    uint64_t get_hash(int id) { return m_hashes[id]; }
+
+    // the support is sorted ascending and contains every variable once
+    const int *support_begin(int id) { return m_support.data() + m_support_offsets[id]; }
+    const int *support_end(int id) { return m_support.data() + m_support_offsets[id + 1]; }
+    int support_size(int id) { return m_support_offsets[id + 1] - m_support_offsets[id]; }
+
+    // creates a logic primitive from the stored data
+    logic_primitive get_primitive(int id);
+    std::vector<logic_primitive> get_primitives(const std::vector<int> &ids);
+};
+}  // namespace planning_logic
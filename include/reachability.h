@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+
+#include "sas_parser.h"
+
+namespace reachability {
+
+// Calculates which facts and operators can be part of a plan at every timestep.
+// The forward pass is a planning graph without mutexes: a fact can hold at t+1 if it can hold at t or an operator
+// that is possible at t adds it. The backward pass uses the domain transition graphs of the goal variables:
+// a fact can only hold at t if the goal value of its variable can be reached in the remaining timesteps.
+// Both passes only remove facts and operators that are false in every plan with the given number of timesteps.
+class timestep_reachability {
+   private:
+    // number of timesteps of the plans. -1 if it is not known, then only the forward pass is used
+    int m_horizon;
+    std::vector<int> m_fact_offsets;
+    // m_possible_facts[t][fact_id] and m_possible_operators[t][op]
+    // if the horizon is unknown, the last layer is the fixpoint and holds for all later timesteps
+    std::vector<std::vector<bool>> m_possible_facts;
+    std::vector<std::vector<bool>> m_possible_operators;
+
+    // distance from every fact to the goal value of its variable in the domain transition graph
+    // facts of variables without a goal have the distance 0
+    std::vector<int> calculate_goal_distances(sas_problem &problem);
+
+   public:
+    timestep_reachability(sas_problem &problem, int horizon);
+
+    bool is_fact_possible(int timestep, int var, int val);
+    bool is_operator_possible(int timestep, int op);
+};
+}  // namespace reachability
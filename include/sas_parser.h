@@ -1,19 +1,23 @@
 #pragma once
 
 #include "graph.h"
+#include "sas_tokenizer.h"
 
+#include <map>
+#include <memory>
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <sstream>
-#include <map>
 
 class variable_info {
    public:
     std::string m_name;
     int m_range;
-    std::vector<std::string> m_symbolic_names;
+    // the names are interned in the string_pool of the sas_problem
+    std::vector<std::string_view> m_symbolic_names;
 
-    variable_info(std::string name, int range, std::vector<std::string> symbolic_name)
+    variable_info(std::string name, int range, std::vector<std::string_view> symbolic_name)
         : m_name(name), m_range(range), m_symbolic_names(symbolic_name) {}
     std::string to_string();
 };
@@ -29,11 +33,70 @@ class operator_info {
     std::string to_string();
 };
 
+// Struct of arrays representation of the operators together with index lists for every fact (variable value pair).
+// All lists are stored as compressed sparse rows: the entries of row i are in [offsets[i], offsets[i+1]).
+// It is built once after parsing and has to be rebuilt if the variables or operators of the problem change.
+class operator_index {
+   public:
+    // the id of fact var=val is m_fact_offsets[var] + val
+    std::vector<int> m_fact_offsets;
+
+    // the effect tuples of every operator in the order of m_effects
+    std::vector<int> m_effect_offsets;
+    std::vector<int> m_effect_vars;
+    std::vector<int> m_effect_pres;
+    std::vector<int> m_effect_posts;
+
+    // preconditions (pre != -1) and effects of every operator sorted by variable
+    std::vector<int> m_pre_offsets;
+    std::vector<int> m_pre_vars;
+    std::vector<int> m_pre_vals;
+    std::vector<int> m_post_offsets;
+    std::vector<int> m_post_vars;
+    std::vector<int> m_post_vals;
+
+    // operators that make a fact true (including prevail conditions).
+    // one entry for every matching effect tuple, sorted by operator
+    std::vector<int> m_adder_offsets;
+    std::vector<int> m_adders;
+    // operators that change the variable of a fact to another value, while the fact may hold before
+    std::vector<int> m_deleter_offsets;
+    std::vector<int> m_deleters;
+    // operators that have the fact as precondition (including prevail conditions)
+    std::vector<int> m_pre_user_offsets;
+    std::vector<int> m_pre_users;
+
+    int fact_id(int var, int val) { return m_fact_offsets[var] + val; }
+    int num_facts() { return m_fact_offsets.empty() ? 0 : m_fact_offsets.back(); }
+
+    int num_effects(int op) { return m_effect_offsets[op + 1] - m_effect_offsets[op]; }
+
+    const int *adders_begin(int var, int val) { return m_adders.data() + m_adder_offsets[fact_id(var, val)]; }
+    const int *adders_end(int var, int val) { return m_adders.data() + m_adder_offsets[fact_id(var, val) + 1]; }
+    const int *deleters_begin(int var, int val) { return m_deleters.data() + m_deleter_offsets[fact_id(var, val)]; }
+    const int *deleters_end(int var, int val) { return m_deleters.data() + m_deleter_offsets[fact_id(var, val) + 1]; }
+    const int *pre_users_begin(int var, int val) {
+        return m_pre_users.data() + m_pre_user_offsets[fact_id(var, val)];
+    }
+    const int *pre_users_end(int var, int val) {
+        return m_pre_users.data() + m_pre_user_offsets[fact_id(var, val) + 1];
+    }
+};
+
+// objects of a planning task that can be permuted arbitrarily without changing the task
+class object_class {
+   public:
+    std::vector<std::string> m_objects;
+    // m_touching_operators[i] are the operators with the ith object as parameter, sorted
+    std::vector<std::vector<int>> m_touching_operators;
+};
+
 class sas_problem {
    private:
-    // checks if two set of variables are consistent (set = set or var_idx, val pairs)
-    // a set if consistent if it doe not conatain v=a and v=b with a!=b
-    bool are_variables_consistent(std::vector<std::pair<int, int>> &set1, std::vector<std::pair<int, int>> &set2);
+    // checks if two sets of (var, val) pairs are consistent. Both sets have to be sorted by variable
+    // the sets are consistent if they do not contain v=a and v=b with a!=b
+    static bool are_facts_consistent(const int *vars1, const int *vals1, int size1, const int *vars2,
+                                     const int *vals2, int size2);
 
    public:
     std::vector<variable_info> m_variabels;
@@ -46,12 +109,48 @@ class sas_problem {
     std::vector<int> m_initial_state;
     std::vector<std::pair<int, int>> m_goal;
 
+    // owns the symbolic names of all variable values. It is shared between all copies of the problem
+    std::shared_ptr<string_pool> m_name_pool = std::make_shared<string_pool>();
+
+    // index over the operators. Is filled by build_operator_index
+    operator_index m_index;
+    // (re)builds m_index from m_variabels and m_operators
+    void build_operator_index();
+
+    // number of original operators every operator stands for. Empty if no operators were merged
+    std::vector<int> m_operator_multiplicities;
+    // removes unreachable values and operators, constant variables and (if remove_irrelevant) variables that are
+    // neither in the goal nor in a precondition. If merge_operators is set, operators with the same preconditions and
+    // effects are merged and their multiplicities are stored. Rebuilds the operator index.
+    // Returns -1 if the goal is not reachable. The problem stays unchanged in this case
+    int simplify(bool remove_irrelevant, bool merge_operators);
+
+    // calculates the pairs of facts that can not hold at the same time with h2 reachability
+    // and adds the ones that are not part of a mutex group yet as mutex groups of size two
+    // returns the number of added mutex groups
+    int add_h2_mutexes();
+
+    // classes of objects that can be exchanged in the names of all facts and operators without changing the
+    // initial state, goal and operators. Only contains classes for which every plan touches every object and every
+    // operator at most one object of the class, so every plan has exactly symmetry_factor() symmetric plans
+    std::vector<object_class> m_object_classes;
+    // fills m_object_classes using the names of the operators and facts. Returns the number of classes
+    int find_symmetric_objects();
+    // product of the number of permutations of all object classes
+    double symmetry_factor();
+
     // checks if two operators are conflicting
     // the are conflicting if one of p1&p2, e1&e2, e1&p2, e2&p1 is not consistent
     bool are_operators_conflicting(int op_idx_1, int op_idx_2);
 
-    graph::undirected_graph construct_action_conflic_graph();
-    graph::undirected_graph construct_complement_action_conflic_graph();
+    // only compares the operators that touch a common variable, using buckets of operators per fact
+    graph::undirected_graph construct_action_conflic_graph(int num_threads = 1);
+    // calls are_operators_conflicting for every pair of operators. Only used to benchmark the version above
+    graph::undirected_graph construct_action_conflic_graph_pairwise();
+    graph::undirected_graph construct_complement_action_conflic_graph(int num_threads = 1);
+    // two operators commute if neither changes a variable the other one reads or changes
+    // then applying them in both orders is possible in the same states and leads to the same state
+    graph::undirected_graph construct_action_commutation_graph();
 };
 
 // returns the legth of the plan found by a fd_run
@@ -66,7 +165,19 @@ class sas_parser {
 
     // returns -1 on error and 0 else
     // fast downward sas file fomat is defined here: https://www.fast-downward.org/TranslatorOutputFormat
+    // the file is memory mapped and tokenized in a single pass. A filepath of "-" reads the problem from stdin
     int start_parsing();
+    // old line based parser. It is only kept to compare against the tokenizer
+    int start_parsing_legacy();
+
+    int parse_sas_version(sas_tokenizer& tokenizer);
+    int parse_sas_metric(sas_tokenizer& tokenizer);
+    int parse_sas_variables(sas_tokenizer& tokenizer);
+    int parse_sas_mutex(sas_tokenizer& tokenizer);
+    int parse_sas_initial_state(sas_tokenizer& tokenizer);
+    int parse_sas_goal(sas_tokenizer& tokenizer);
+    int parse_sas_operator(sas_tokenizer& tokenizer);
+    int parse_sas_axiom(sas_tokenizer& tokenizer);
 
     int parse_sas_version(std::ifstream& infile);
     int parse_sas_metric(std::ifstream& infile);
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Stores every distinct string exactly once. The returned views stay valid as long as the pool lives.
+// Used for the symbolic value names of the sas variables, which repeat a lot (e.g. "<none of those>").
+class string_pool {
+   private:
+    std::deque<std::string> m_storage;
+    std::unordered_map<std::string_view, std::string_view> m_lookup;
+
+   public:
+    std::string_view intern(std::string_view str);
+    int size() { return m_storage.size(); }
+};
+
+// Single pass tokenizer over a memory mapped sas file.
+// If the file can not be mapped (e.g. "-" for stdin or a pipe from the translator), the input is read into a buffer
+// once. All returned string views point directly into the mapped bytes.
+class sas_tokenizer {
+   private:
+    const char *m_begin = nullptr;
+    const char *m_cursor = nullptr;
+    const char *m_end = nullptr;
+
+    // is set if the input is mapped and has to be unmapped in the destructor
+    void *m_mapping = nullptr;
+    size_t m_mapping_size = 0;
+    // fallback storage for input that can not be mapped
+    std::vector<char> m_buffer;
+
+    // is true, if the last token was read with next_int and the rest of its line was not consumed yet
+    bool m_inside_line = false;
+
+    bool read_file_descriptor(int fd);
+
+   public:
+    sas_tokenizer() {}
+    ~sas_tokenizer();
+    sas_tokenizer(const sas_tokenizer &) = delete;
+    sas_tokenizer &operator=(const sas_tokenizer &) = delete;
+
+    // opens the file at the given path. "-" reads from stdin
+    // returns false if the input could not be opened
+    bool open(const std::string &file_path);
+
+    bool at_end();
+    // returns the next line without the line break
+    std::string_view next_line();
+    // reads the next whitespace separated integer. returns false if there is none
+    bool next_int(int &value);
+    // returns true if the next line equals the expected string
+    bool expect_line(std::string_view expected);
+};
@@ -30,7 +30,11 @@ class sdd_container : public virtual dd_buildable {
 
     void add_clause_primitive(std::vector<int> &clause, int sdd_index = 0);
     void add_exactly_one_primitive(std::vector<int> &variables, int sdd_index = 0);
+    void add_at_most_one_primitive(std::vector<int> &literals, int sdd_index = 0);
     void add_dnf_primitive(std::vector<std::vector<int>> &dnf, int bdd_index = 0);
+    void add_implication_primitive(std::vector<int> &antecedent, std::vector<int> &consequent, int sdd_index = 0);
+    void add_transition_primitive(std::vector<std::vector<int>> &terms, std::vector<int> &dnf_offsets,
+                                  int sdd_index = 0);
     
     void create_ith_var(int i);
     void set_variable_group(int low, int size);
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work stealing thread pool.
+// Every worker owns a queue. It takes its own tasks from the back and steals from the front of the other queues, if
+// its queue is empty. The calling thread helps with the work, while it waits for the tasks to finish.
+class thread_pool {
+   private:
+    struct task_queue {
+        std::mutex m_mutex;
+        std::deque<std::function<void()>> m_tasks;
+    };
+
+    // one queue per worker and one for the calling thread (the last one)
+    std::vector<std::unique_ptr<task_queue>> m_queues;
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_state_mutex;
+    std::condition_variable m_work_available;
+    std::condition_variable m_work_done;
+    // number of tasks that are queued or running
+    std::atomic<int> m_num_pending;
+    // number of tasks that are queued
+    std::atomic<int> m_num_queued;
+    bool m_stop = false;
+
+    // takes a task from the own queue or steals one from another queue
+    bool try_get_task(int queue_index, std::function<void()> &task);
+    void run_worker(int queue_index);
+    void finish_task();
+
+   public:
+    // num_threads includes the calling thread. A pool with one thread runs everything on the calling thread
+    thread_pool(int num_threads);
+    ~thread_pool();
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    int num_threads() { return m_workers.size() + 1; }
+
+    // calls f(i) for every i in [0, n) and returns when all calls are done
+    // the calls are split into chunks of consecutive indices
+    void parallel_for(int n, const std::function<void(int)> &f);
+};
@@ -144,6 +144,59 @@ double bdd_container::count_num_solutions(int dd_index, int nvars) {
     return Cudd_CountMinterm(m_bdd_manager, m_root_nodes[dd_index], nvars);
 }
 
+double bdd_container::count_weighted_solutions(int dd_index, std::vector<double> &weights) {
+    // total weight (1 + w) of every level
+    int num_levels = Cudd_ReadSize(m_bdd_manager);
+    std::vector<double> level_weights(num_levels);
+    for (int level = 0; level < num_levels; level++) {
+        int v = Cudd_ReadInvPerm(m_bdd_manager, level);
+        level_weights[level] = 1 + (v < weights.size() ? weights[v] : 1);
+    }
+
+    std::unordered_map<DdNode *, double> cache;
+    DdNode *root = m_root_nodes[dd_index];
+    return weighted_count(root, level_weights, weights, cache) * skipped_weight(-1, node_level(root), level_weights);
+}
+
+int bdd_container::node_level(DdNode *node) {
+    DdNode *regular = Cudd_Regular(node);
+    return Cudd_IsConstant(regular) ? Cudd_ReadSize(m_bdd_manager)
+                                    : Cudd_ReadPerm(m_bdd_manager, Cudd_NodeReadIndex(regular));
+}
+
+double bdd_container::skipped_weight(int parent_level, int child_level, std::vector<double> &level_weights) {
+    double result = 1;
+    for (int level = parent_level + 1; level < child_level; level++) {
+        result *= level_weights[level];
+    }
+    return result;
+}
+
+double bdd_container::weighted_count(DdNode *node, std::vector<double> &level_weights, std::vector<double> &weights,
+                                     std::unordered_map<DdNode *, double> &cache) {
+    // complemented edges are followed instead of subtracting from the total weight. Without subtractions the count
+    // keeps the full relative precision of a double
+    DdNode *regular = Cudd_Regular(node);
+    if (Cudd_IsConstant(regular)) {
+        return node == Cudd_ReadOne(m_bdd_manager) ? 1 : 0;
+    }
+    auto cached = cache.find(node);
+    if (cached != cache.end()) {
+        return cached->second;
+    }
+
+    int level = node_level(regular);
+    int v = Cudd_NodeReadIndex(regular);
+    double w = v < weights.size() ? weights[v] : 1;
+    DdNode *low = Cudd_NotCond(Cudd_E(regular), Cudd_IsComplement(node));
+    DdNode *high = Cudd_NotCond(Cudd_T(regular), Cudd_IsComplement(node));
+    double result =
+        weighted_count(low, level_weights, weights, cache) * skipped_weight(level, node_level(low), level_weights) +
+        w * weighted_count(high, level_weights, weights, cache) * skipped_weight(level, node_level(high), level_weights);
+    cache[node] = result;
+    return result;
+}
+
 void bdd_container::add_clause_primitive(std::vector<int> &clause, int bdd_index) {
     // build the disjunction of the literals in the clause
     DdNode *var, *tmp;
@@ -227,6 +280,50 @@ void bdd_container::add_exactly_one_primitive(std::vector<int> &variables, int b
     m_root_nodes[bdd_index] = tmp;
 }
 
+void bdd_container::add_at_most_one_primitive(std::vector<int> &literals, int bdd_index) {
+    if (literals.size() <= 1) {
+        return;
+    }
+
+    // order literals by the variable order, the literal in the lowest layer comes first
+    std::vector<std::pair<int, int>> layer_zipped_literals;
+    for (int i = 0; i < literals.size(); i++) {
+        int layer = Cudd_ReadPerm(m_bdd_manager, std::abs(literals[i]));
+        layer_zipped_literals.push_back(std::make_pair(layer, literals[i]));
+    }
+    std::sort(layer_zipped_literals.begin(), layer_zipped_literals.end(), std::greater<>());
+
+    // none_true: none of the literals below is true
+    // at_most_one_true: at most one of the literals below is true
+    DdNode *false_node = Cudd_ReadLogicZero(m_bdd_manager);
+    DdNode *none_true = Cudd_ReadOne(m_bdd_manager);
+    Cudd_Ref(none_true);
+    DdNode *at_most_one_true = Cudd_ReadOne(m_bdd_manager);
+    Cudd_Ref(at_most_one_true);
+
+    for (int i = 0; i < layer_zipped_literals.size(); i++) {
+        int literal = layer_zipped_literals[i].second;
+        DdNode *literal_node = Cudd_NotCond(Cudd_bddIthVar(m_bdd_manager, std::abs(literal)), literal < 0);
+        DdNode *new_none_true = Cudd_bddIte(m_bdd_manager, literal_node, false_node, none_true);
+        Cudd_Ref(new_none_true);
+        DdNode *new_at_most_one_true = Cudd_bddIte(m_bdd_manager, literal_node, none_true, at_most_one_true);
+        Cudd_Ref(new_at_most_one_true);
+
+        Cudd_RecursiveDeref(m_bdd_manager, none_true);
+        Cudd_RecursiveDeref(m_bdd_manager, at_most_one_true);
+        none_true = new_none_true;
+        at_most_one_true = new_at_most_one_true;
+    }
+    Cudd_RecursiveDeref(m_bdd_manager, none_true);
+
+    // conjoin the root node for the at most one constraint with the root node of the bdd
+    DdNode *tmp = Cudd_bddAnd(m_bdd_manager, m_root_nodes[bdd_index], at_most_one_true);
+    Cudd_Ref(tmp);
+    Cudd_RecursiveDeref(m_bdd_manager, m_root_nodes[bdd_index]);
+    Cudd_RecursiveDeref(m_bdd_manager, at_most_one_true);
+    m_root_nodes[bdd_index] = tmp;
+}
+
 void bdd_container::add_dnf_primitive(std::vector<std::vector<int>> &dnf, int bdd_index) {
     // build the disjunction of the literals in the clause
     DdNode *var, *tmp;
@@ -264,6 +361,80 @@ void bdd_container::add_dnf_primitive(std::vector<std::vector<int>> &dnf, int bd
     m_root_nodes[bdd_index] = tmp;
 }
 
+DdNode *bdd_container::compute_cube(std::vector<int> &literals) {
+    std::vector<DdNode *> vars(literals.size());
+    std::vector<int> phases(literals.size());
+    for (int i = 0; i < literals.size(); i++) {
+        vars[i] = Cudd_bddIthVar(m_bdd_manager, std::abs(literals[i]));
+        phases[i] = literals[i] > 0 ? 1 : 0;
+    }
+    DdNode *cube = Cudd_bddComputeCube(m_bdd_manager, vars.data(), phases.data(), literals.size());
+    Cudd_Ref(cube);
+    return cube;
+}
+
+void bdd_container::add_implication_primitive(std::vector<int> &antecedent, std::vector<int> &consequent,
+                                              int bdd_index) {
+    DdNode *antecedent_cube = compute_cube(antecedent);
+    DdNode *consequent_cube = compute_cube(consequent);
+
+    // antecedent -> consequent == ite(antecedent, consequent, 1)
+    DdNode *implication = Cudd_bddIte(m_bdd_manager, antecedent_cube, consequent_cube, Cudd_ReadOne(m_bdd_manager));
+    Cudd_Ref(implication);
+    Cudd_RecursiveDeref(m_bdd_manager, antecedent_cube);
+    Cudd_RecursiveDeref(m_bdd_manager, consequent_cube);
+
+    DdNode *tmp = Cudd_bddAnd(m_bdd_manager, m_root_nodes[bdd_index], implication);
+    Cudd_Ref(tmp);
+    Cudd_RecursiveDeref(m_bdd_manager, m_root_nodes[bdd_index]);
+    Cudd_RecursiveDeref(m_bdd_manager, implication);
+    m_root_nodes[bdd_index] = tmp;
+}
+
+void bdd_container::add_transition_primitive(std::vector<std::vector<int>> &terms, std::vector<int> &dnf_offsets,
+                                             int bdd_index) {
+    // order the dnfs by the highest layer of their variables, the dnf that starts in the lowest layer comes first
+    std::vector<std::pair<int, int>> layer_zipped_dnfs;
+    for (int d = 0; d + 1 < dnf_offsets.size(); d++) {
+        int top_layer = Cudd_ReadSize(m_bdd_manager);
+        for (int t = dnf_offsets[d]; t < dnf_offsets[d + 1]; t++) {
+            for (int l : terms[t]) {
+                top_layer = std::min(top_layer, Cudd_ReadPerm(m_bdd_manager, std::abs(l)));
+            }
+        }
+        layer_zipped_dnfs.push_back(std::make_pair(top_layer, d));
+    }
+    std::sort(layer_zipped_dnfs.begin(), layer_zipped_dnfs.end(), std::greater<>());
+
+    DdNode *transition = Cudd_ReadOne(m_bdd_manager);
+    Cudd_Ref(transition);
+    for (std::pair<int, int> &layer_dnf : layer_zipped_dnfs) {
+        int d = layer_dnf.second;
+        DdNode *disjunction = Cudd_ReadLogicZero(m_bdd_manager);
+        Cudd_Ref(disjunction);
+        for (int t = dnf_offsets[d]; t < dnf_offsets[d + 1]; t++) {
+            DdNode *cube = compute_cube(terms[t]);
+            DdNode *tmp = Cudd_bddOr(m_bdd_manager, disjunction, cube);
+            Cudd_Ref(tmp);
+            Cudd_RecursiveDeref(m_bdd_manager, disjunction);
+            Cudd_RecursiveDeref(m_bdd_manager, cube);
+            disjunction = tmp;
+        }
+
+        DdNode *tmp = Cudd_bddAnd(m_bdd_manager, transition, disjunction);
+        Cudd_Ref(tmp);
+        Cudd_RecursiveDeref(m_bdd_manager, transition);
+        Cudd_RecursiveDeref(m_bdd_manager, disjunction);
+        transition = tmp;
+    }
+
+    DdNode *tmp = Cudd_bddAnd(m_bdd_manager, m_root_nodes[bdd_index], transition);
+    Cudd_Ref(tmp);
+    Cudd_RecursiveDeref(m_bdd_manager, m_root_nodes[bdd_index]);
+    Cudd_RecursiveDeref(m_bdd_manager, transition);
+    m_root_nodes[bdd_index] = tmp;
+}
+
 void bdd_container::hack_back_rocket_method() { return; }
 
 void bdd_container::disable_reordering() { Cudd_AutodynDisable(m_bdd_manager); }
@@ -337,17 +508,15 @@ void bdd_container::conjoin_two_dds(int bbd_a, int bdd_b, int bdd_result) {
     m_root_nodes[bdd_result] = tmp;
 }
 
-std::map<int, int> bdd_container::get_variable_order_for_single_step(
-    std::map<planning_logic::tagged_variable, int> &variable_map) {
+std::map<int, int> bdd_container::get_variable_order_for_single_step(planning_logic::plan_to_cnf_map &symbol_map) {
     std::map<int, int> layer_to_index;
     std::map<int, int> consolidated_index_to_layer;  // same as above but with no gaps in the layers
     // dummy 0 var has alway should be at layer 0
     layer_to_index[0] = 0;
 
-    for (std::map<planning_logic::tagged_variable, int>::iterator iter = variable_map.begin();
-         iter != variable_map.end(); ++iter) {
-        planning_logic::tagged_variable tagged_var = iter->first;
-        int index = iter->second;
+    for (std::tuple<planning_logic::tagged_variable, int> &entry : symbol_map.get_variables_in_key_order()) {
+        planning_logic::tagged_variable tagged_var = std::get<0>(entry);
+        int index = std::get<1>(entry);
 
         int t = std::get<1>(tagged_var);
         if (t != 0) {
@@ -371,8 +540,8 @@ std::map<int, int> bdd_container::get_variable_order_for_single_step(
     return consolidated_index_to_layer;
 }
 
-std::vector<int> bdd_container::extend_variable_order_to_all_steps(
-    std::map<planning_logic::tagged_variable, int> &variable_map, std::map<int, int> &single_step_order) {
+std::vector<int> bdd_container::extend_variable_order_to_all_steps(planning_logic::plan_to_cnf_map &symbol_map,
+                                                                  std::map<int, int> &single_step_order) {
     LOG_MESSAGE(log_level::info) << "Extending Variable order to multiple timesteps. single step size: "
                                  << single_step_order.size();
 
@@ -380,16 +549,14 @@ std::vector<int> bdd_container::extend_variable_order_to_all_steps(
     std::map<int, int> layer_to_index;
     std::vector<int> result_index_to_layer_map;
 
-    for (std::map<planning_logic::tagged_variable, int>::iterator iter = variable_map.begin();
-         iter != variable_map.end(); ++iter) {
-        planning_logic::tagged_variable tagged_var = iter->first;
-        int index = iter->second;
+    for (std::tuple<planning_logic::tagged_variable, int> &entry : symbol_map.get_variables_in_key_order()) {
+        planning_logic::tagged_variable tagged_var = std::get<0>(entry);
+        int index = std::get<1>(entry);
         int t = std::get<1>(tagged_var);
 
-        // create a var tuple that represents the variable in timestep 0 and calculates its layer in the single step bdd
-        planning_logic::tagged_variable zero_step_tagged_var = tagged_var;
-        std::get<1>(zero_step_tagged_var) = 0;
-        int index_of_zero_step_var = variable_map[zero_step_tagged_var];
+        // calculates the layer of the variable in timestep 0 in the single step bdd
+        int index_of_zero_step_var = symbol_map.get_variable_index_without_adding(
+            std::get<0>(tagged_var), 0, std::get<2>(tagged_var), std::get<3>(tagged_var));
         int layer_in_zero_step = single_step_order[index_of_zero_step_var];
         int layer_in_t_step = (t * num_variables_in_one_timestep) + layer_in_zero_step;
 
@@ -397,7 +564,7 @@ std::vector<int> bdd_container::extend_variable_order_to_all_steps(
     }
 
     // consolidate the layers
-    result_index_to_layer_map = std::vector<int>(variable_map.size() + 1);  // +1 for the dummy 0 var
+    result_index_to_layer_map = std::vector<int>(symbol_map.get_num_variables() + 1);  // +1 for the dummy 0 var
     result_index_to_layer_map[0] = 0;
     int new_layer = 1;
     for (std::map<int, int>::iterator iter = layer_to_index.begin(); iter != layer_to_index.end(); ++iter) {
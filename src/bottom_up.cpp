@@ -2,35 +2,45 @@
 
 #include <algorithm>
 #include <iostream>
+#include <tuple>
 
 namespace conjoin_order {
 
 // returns the highest level that is affected by this primitive
 // highest level means lowest integer value in this case
 // primitives with higher levels should be conjoined first
-int highest_level(const planning_logic::logic_primitive &primitive, const std::vector<int> &variable_order) {
+int highest_level(planning_logic::primitive_store &store, int id, const std::vector<int> &variable_order) {
     int highest_level = variable_order.size() + 1;  // lower values are "higher"
-    std::vector<int> affected_variables = primitive.get_affected_variables();
-    for (int i = 0; i < affected_variables.size(); i++) {
-        //std::cout << "affected var " << affected_variables[i] << " at pos " << variable_order[affected_variables[i]] << std::endl;
-
-        int level = variable_order[affected_variables[i]];
+    for (const int *v = store.support_begin(id); v != store.support_end(id); v++) {
+        int level = variable_order[*v];
         highest_level = std::min(level, highest_level);
     }
     return highest_level;
 }
 
 // variable order maps var index to position
-void sort_bottom_up(std::vector<planning_logic::logic_primitive> &primitives, int start, int end,
+void sort_bottom_up(planning_logic::primitive_store &store, std::vector<int> &primitive_ids, int start, int end,
                     const std::vector<int> &variable_order) {
-    std::sort(primitives.begin() + start, primitives.begin() + end,
-              [&](const planning_logic::logic_primitive &a, const planning_logic::logic_primitive &b) {
-                  if (highest_level(a, variable_order) == highest_level(b, variable_order)) {
-                      return a.get_affected_variables().size() <= b.get_affected_variables().size();
+    // calculate the sort keys once for every primitive
+    std::vector<std::tuple<int, int, int>> keyed_ids;  // highest level, support size, id
+    keyed_ids.reserve(end - start);
+    for (int i = start; i < end; i++) {
+        int id = primitive_ids[i];
+        keyed_ids.push_back(std::make_tuple(highest_level(store, id, variable_order), store.support_size(id), id));
+    }
+
+    std::sort(keyed_ids.begin(), keyed_ids.end(),
+              [](const std::tuple<int, int, int> &a, const std::tuple<int, int, int> &b) {
+                  if (std::get<0>(a) == std::get<0>(b)) {
+                      return std::get<1>(a) < std::get<1>(b);
                   } else {
-                      return highest_level(a, variable_order) > highest_level(b, variable_order);
+                      return std::get<0>(a) > std::get<0>(b);
                   }
               });
+
+    for (int i = start; i < end; i++) {
+        primitive_ids[i] = std::get<2>(keyed_ids[i - start]);
+    }
 }
 
-}  // namespace conjoin_order
\ No newline at end of file
+}  // namespace conjoin_order
@@ -0,0 +1,141 @@
+#include "code_assignment.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <tuple>
+
+#include "logging.h"
+
+namespace code_assignment {
+
+namespace {
+
+int num_bits(int size) { return size <= 1 ? 0 : (int)std::ceil(std::log2(size)); }
+
+// the entry of the ith index of the order is the gray code of i. The unused codes follow in the same way
+std::vector<int> gray_codes_for_order(const std::vector<int> &order, int size) {
+    std::vector<int> codes(1 << num_bits(size));
+    for (int i = 0; i < order.size(); i++) {
+        codes[order[i]] = gray_code(i);
+    }
+    for (int i = order.size(); i < codes.size(); i++) {
+        codes[i] = gray_code(i);
+    }
+    return codes;
+}
+
+// operators that change the same variables follow each other, within them the ones with the same values
+std::vector<int> cluster_operators(sas_problem &problem) {
+    operator_index &index = problem.m_index;
+    std::vector<std::tuple<std::vector<int>, std::vector<std::tuple<int, int, int>>, int>> keys;
+    for (int op = 0; op < problem.m_operators.size(); op++) {
+        std::vector<int> changed;
+        std::vector<std::tuple<int, int, int>> effects;
+        for (int eff = index.m_effect_offsets[op]; eff < index.m_effect_offsets[op + 1]; eff++) {
+            if (index.m_effect_pres[eff] != index.m_effect_posts[eff]) {
+                changed.push_back(index.m_effect_vars[eff]);
+            }
+            effects.push_back(
+                std::make_tuple(index.m_effect_vars[eff], index.m_effect_pres[eff], index.m_effect_posts[eff]));
+        }
+        std::sort(changed.begin(), changed.end());
+        std::sort(effects.begin(), effects.end());
+        keys.push_back(std::make_tuple(changed, effects, op));
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<int> order;
+    for (auto &key : keys) {
+        order.push_back(std::get<2>(key));
+    }
+    return order;
+}
+
+// breadth first order of the values in the undirected domain transition graph, starting at the initial value
+// effects are the effect tuples of the operator index that change the variable
+std::vector<int> cluster_values(sas_problem &problem, int var, const std::vector<int> &effects) {
+    operator_index &index = problem.m_index;
+    int range = problem.m_variabels[var].m_range;
+    std::vector<std::vector<bool>> is_neighbour(range, std::vector<bool>(range, false));
+    for (int eff : effects) {
+        int pre = index.m_effect_pres[eff];
+        int post = index.m_effect_posts[eff];
+        for (int val = 0; val < range; val++) {
+            if ((pre == -1 || pre == val) && val != post) {
+                is_neighbour[val][post] = true;
+                is_neighbour[post][val] = true;
+            }
+        }
+    }
+
+    std::vector<int> order;
+    std::vector<bool> visited(range, false);
+    for (int i = 0; i < range; i++) {
+        int start = i == 0 ? problem.m_initial_state[var] : i;
+        if (visited[start]) {
+            continue;
+        }
+        std::queue<int> queue;
+        visited[start] = true;
+        queue.push(start);
+        while (!queue.empty()) {
+            int val = queue.front();
+            queue.pop();
+            order.push_back(val);
+            for (int next = 0; next < range; next++) {
+                if (is_neighbour[val][next] && !visited[next]) {
+                    visited[next] = true;
+                    queue.push(next);
+                }
+            }
+        }
+    }
+    return order;
+}
+
+std::vector<int> index_order(int size) {
+    std::vector<int> order(size);
+    for (int i = 0; i < size; i++) {
+        order[i] = i;
+    }
+    return order;
+}
+}  // namespace
+
+bool is_valid_strategy(const std::string &strategy) {
+    return strategy == "plain" || strategy == "gray" || strategy == "cluster";
+}
+
+binary_codes assign_codes(sas_problem &problem, const std::string &strategy) {
+    binary_codes result;
+    if (strategy == "plain") {
+        return result;
+    }
+
+    int num_operators = problem.m_operators.size();
+    if (strategy == "cluster") {
+        result.m_op_codes = gray_codes_for_order(cluster_operators(problem), num_operators);
+    } else {
+        result.m_op_codes = gray_codes_for_order(index_order(num_operators), num_operators);
+    }
+    std::vector<std::vector<int>> changing_effects(problem.m_variabels.size());
+    operator_index &index = problem.m_index;
+    for (int eff = 0; eff < index.m_effect_vars.size(); eff++) {
+        if (index.m_effect_pres[eff] != index.m_effect_posts[eff]) {
+            changing_effects[index.m_effect_vars[eff]].push_back(eff);
+        }
+    }
+    for (int var = 0; var < problem.m_variabels.size(); var++) {
+        int range = problem.m_variabels[var].m_range;
+        if (strategy == "cluster") {
+            result.m_var_codes.push_back(
+                gray_codes_for_order(cluster_values(problem, var, changing_effects[var]), range));
+        } else {
+            result.m_var_codes.push_back(gray_codes_for_order(index_order(range), range));
+        }
+    }
+    LOG_MESSAGE(log_level::info) << "Assigned the " << strategy << " codes for the binary encoding";
+    return result;
+}
+}  // namespace code_assignment
@@ -38,6 +38,11 @@ void construct_dd(dd_buildable &container, encoder_abstract &encoder, option_val
 
 void construct_dd_linear(dd_buildable &container, encoder_abstract &encoder, option_values &options, bool silent) {
     LOG_MESSAGE(log_level::info) << "Building dd linear with t=" << options.timesteps << " timestpes";
+    if (options.stream_primitives) {
+        conjoin_order::primitive_stream stream(encoder, options);
+        conjoin_primitive_stream(container, stream, 0, silent);
+        return;
+    }
     LOG_MESSAGE(log_level::info) << "Ordering all clauses";
     std::vector<logic_primitive> all_primitives = conjoin_order::order_all_clauses(encoder, options);
     conjoin_primitives_linear(container, all_primitives, 0, silent);
@@ -361,6 +366,32 @@ void construct_dd_without_timesteps(dd_buildable &container, encoder_abstract &e
     }
 }
 
+void conjoin_primitive(dd_buildable &dd, logic_primitive &primitive, int dd_index) {
+    switch (primitive.m_type) {
+        case logic_clause:
+            dd.add_clause_primitive(primitive.m_data, dd_index);
+            break;
+        case logic_dnf:
+            dd.add_dnf_primitive(primitive.m_dnf_data, dd_index);
+            break;
+        case logic_eo:
+            dd.add_exactly_one_primitive(primitive.m_data, dd_index);
+            break;
+        case logic_amo:
+            dd.add_at_most_one_primitive(primitive.m_data, dd_index);
+            break;
+        case logic_implication:
+            dd.add_implication_primitive(primitive.m_dnf_data[0], primitive.m_dnf_data[1], dd_index);
+            break;
+        case logic_transition:
+            dd.add_transition_primitive(primitive.m_dnf_data, primitive.m_dnf_offsets, dd_index);
+            break;
+        default:
+            LOG_MESSAGE(log_level::warning) << "Unknown logic primitive type during DD construction";
+            break;
+    }
+}
+
 void conjoin_primitives_linear(dd_buildable &dd, std::vector<logic_primitive> &logic_primitives, int dd_index,
                                bool silent) {
     if (!silent) {
@@ -369,28 +400,7 @@ void conjoin_primitives_linear(dd_buildable &dd, std::vector<logic_primitive> &l
     // conjoin the clauses in the correct order
     int percent = 0;
     for (int i = 0; i < logic_primitives.size(); i++) {
-        planning_logic::logic_primitive primitive = logic_primitives[i];
-
-        // std::cout << "affected vars ";
-        // for(int a: primitive.get_affected_variables()){
-        //     std::cout << a << " ";
-        // }
-        // std::cout << std::endl;
-
-        switch (primitive.m_type) {
-            case logic_clause:
-                dd.add_clause_primitive(primitive.m_data, dd_index);
-                break;
-            case logic_dnf:
-                dd.add_dnf_primitive(primitive.m_dnf_data, dd_index);
-                break;
-            case logic_eo:
-                dd.add_exactly_one_primitive(primitive.m_data, dd_index);
-                break;
-            default:
-                LOG_MESSAGE(log_level::warning) << "Unknown logic primitive type during DD construction";
-                break;
-        }
+        conjoin_primitive(dd, logic_primitives[i], dd_index);
         int new_percent = (100 * (i + 1)) / logic_primitives.size();
         if (new_percent > percent) {
             percent = new_percent;
@@ -405,4 +415,30 @@ void conjoin_primitives_linear(dd_buildable &dd, std::vector<logic_primitive> &l
     }
 }
 
+void conjoin_primitive_stream(dd_buildable &dd, conjoin_order::primitive_stream &stream, int dd_index, bool silent) {
+    if (!silent) {
+        LOG_MESSAGE(log_level::info) << "Start constructing DD from a stream of logic primitives";
+    }
+    int percent = 0;
+    long num_primitives = 0;
+    std::vector<logic_primitive> primitives;
+    while (stream.next(primitives)) {
+        for (logic_primitive &primitive : primitives) {
+            conjoin_primitive(dd, primitive, dd_index);
+        }
+        num_primitives += primitives.size();
+        int new_percent = (100 * stream.num_taken()) / stream.num_pairs();
+        if (new_percent > percent) {
+            percent = new_percent;
+            if (!silent) {
+                LOG_MESSAGE(log_level::info) << "Conjoined " << percent << "% of all (tag, timestep) pairs. "
+                                                    + dd.get_short_statistics(dd_index);
+            }
+        }
+    }
+    if (!silent) {
+        LOG_MESSAGE(log_level::info) << "Finished constructing DD from " << num_primitives << " primitives";
+    }
+}
+
 }  // namespace dd_builder
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "dd_builder_variable_order.h"
 #include "force.h"
 #include "logging.h"
+#include "preprocessing.h"
 
 using namespace planning_logic;
 using namespace encoder;
@@ -73,42 +74,50 @@ std::vector<logic_primitive> order_all_clauses(encoder_abstract &encoder, option
         return std::vector<logic_primitive>();
     }
 
-    std::vector<logic_primitive> ordered_primitives;
+    primitive_store store;
+    std::vector<int> ordered_ids;
 
     if (options.clause_order_force) {
-        std::vector<std::tuple<logic_primitive, int>> temp = create_force_clause_order_mapping(encoder, options);
+        std::vector<std::tuple<int, int>> temp = create_force_clause_order_mapping(encoder, store, options);
         for (int i = 0; i < temp.size(); i++) {
-            ordered_primitives.push_back(std::get<0>(temp[i]));
+            ordered_ids.push_back(std::get<0>(temp[i]));
         }
     } else if (options.clause_order_custom) {
-        std::vector<std::tuple<logic_primitive, int>> temp = create_custom_clause_order_mapping(encoder, options);
+        std::vector<std::tuple<int, int>> temp = create_custom_clause_order_mapping(encoder, store, options);
         for (int i = 0; i < temp.size(); i++) {
-            ordered_primitives.push_back(std::get<0>(temp[i]));
+            ordered_ids.push_back(std::get<0>(temp[i]));
         }
     } else if (options.clause_order_custom_force) {
-        std::vector<std::tuple<logic_primitive, int>> order = create_custom_clause_order_mapping(encoder, options);
-        std::vector<std::tuple<logic_primitive, int>> tiebreak = create_force_clause_order_mapping(encoder, options);
-        std::vector<std::tuple<logic_primitive, int, int>> temp = create_mixed_clause_order_mapping(order, tiebreak);
+        std::vector<std::tuple<int, int>> order = create_custom_clause_order_mapping(encoder, store, options);
+        std::vector<std::tuple<int, int>> tiebreak = create_force_clause_order_mapping(encoder, store, options);
+        std::vector<std::tuple<int, int, int>> temp = create_mixed_clause_order_mapping(order, tiebreak, store.size());
         for (int i = 0; i < temp.size(); i++) {
-            ordered_primitives.push_back(std::get<0>(temp[i]));
+            ordered_ids.push_back(std::get<0>(temp[i]));
         }
     } else if (options.clause_order_bottom_up) {
-        std::vector<std::tuple<logic_primitive, int>> temp = create_bottom_up_clause_order_mapping(encoder, options);
+        std::vector<std::tuple<int, int>> temp = create_bottom_up_clause_order_mapping(encoder, store, options);
         for (int i = 0; i < temp.size(); i++) {
-            ordered_primitives.push_back(std::get<0>(temp[i]));
+            ordered_ids.push_back(std::get<0>(temp[i]));
         }
     } else if (options.clause_order_custom_bottom_up) {
-        std::vector<std::tuple<logic_primitive, int>> order = create_custom_clause_order_mapping(encoder, options);
-        std::vector<std::tuple<logic_primitive, int>> tiebreak =
-            create_bottom_up_clause_order_mapping(encoder, options);
-        std::vector<std::tuple<logic_primitive, int, int>> temp = create_mixed_clause_order_mapping(order, tiebreak);
+        std::vector<std::tuple<int, int>> order = create_custom_clause_order_mapping(encoder, store, options);
+        std::vector<std::tuple<int, int>> tiebreak = create_bottom_up_clause_order_mapping(encoder, store, options);
+        std::vector<std::tuple<int, int, int>> temp = create_mixed_clause_order_mapping(order, tiebreak, store.size());
         for (int i = 0; i < temp.size(); i++) {
-            ordered_primitives.push_back(std::get<0>(temp[i]));
+            ordered_ids.push_back(std::get<0>(temp[i]));
         }
     } else {
         LOG_MESSAGE(log_level::error) << "No known conjoin order selected";
     }
 
+    std::vector<logic_primitive> ordered_primitives = store.get_primitives(ordered_ids);
+    // the ordered primitives are the only copy that is needed from here on
+    encoder.clear_primitive_cache();
+
+    if (options.preprocess) {
+        ordered_primitives = preprocessing::simplify_primitives(ordered_primitives);
+    }
+
     // this reverses the order of the clauses. It allows the variables with the highes timesteps to be conjoined first
     if (options.reverse_order) {
         LOG_MESSAGE(log_level::info) << "Reversing order of the logic primitives";
@@ -119,15 +128,10 @@ std::vector<logic_primitive> order_all_clauses(encoder_abstract &encoder, option
     return ordered_primitives;
 }
 
-std::vector<std::tuple<logic_primitive, int>> create_custom_clause_order_mapping(encoder_abstract &encoder,
-                                                                                 option_values &options) {
-    LOG_MESSAGE(log_level::info) << "Calculating custom conjoin order";
-
+std::vector<std::tuple<primitive_tag, int>> create_custom_order_keys(option_values &options,
+                                                                      std::vector<int> &key_order) {
     std::string build_order = options.build_order;
-    int custom_order_counter;  // counter that implies the partial order
-
-    // contains the result at the end
-    std::vector<std::tuple<logic_primitive, int>> result;
+    int custom_order_counter = 0;  // counter that implies the partial order
 
     // split the order into first and second part (in a really complicated manner)
     std::stringstream ss(build_order);
@@ -136,6 +140,7 @@ std::vector<std::tuple<logic_primitive, int>> create_custom_clause_order_mapping
     std::getline(ss, interleaved_order, ':');
     std::getline(ss, tail_part, ':');
 
+    std::vector<std::tuple<primitive_tag, int>> keys;
     for (int i = 0; i < disjoin_order.size(); i++) {
         char current_char = disjoin_order[i];
         // add the interleved part
@@ -147,11 +152,8 @@ std::vector<std::tuple<logic_primitive, int>> create_custom_clause_order_mapping
                     primitive_tag order_tag = char_tag_map[interleaved_char];
                     // only add last timestep for exact one var clauses
                     if (t != options.timesteps || interleaved_char == 'r') {
-                        std::vector<logic_primitive> temp_clauses =
-                            collect_primitives_for_single_timestep(encoder, order_tag, t);
-                        for (int k = 0; k < temp_clauses.size(); k++) {
-                            result.push_back(std::make_tuple(temp_clauses[k], custom_order_counter));
-                        }
+                        keys.push_back(std::make_tuple(order_tag, t));
+                        key_order.push_back(custom_order_counter);
                     }
                     if (options.split_inside_timestep) {
                         custom_order_counter++;  // increase counter after every category in a timestep
@@ -162,33 +164,59 @@ std::vector<std::tuple<logic_primitive, int>> create_custom_clause_order_mapping
             // sort the disjoint part
         } else {
             primitive_tag order_tag = char_tag_map[current_char];
-            std::vector<logic_primitive> temp_clauses;
+            int first_timestep, last_timestep;
             if (order_tag == ini_state) {
-                temp_clauses = collect_primitives_for_single_timestep(encoder, order_tag, 0);
+                first_timestep = last_timestep = 0;
             } else if (order_tag == goal) {
-                temp_clauses = collect_primitives_for_single_timestep(encoder, order_tag, options.timesteps);
+                first_timestep = last_timestep = options.timesteps;
             } else if (order_tag == eo_var) {
-                temp_clauses = collect_primitives_for_all_timesteps(encoder, order_tag, options.timesteps);
+                first_timestep = 0;
+                last_timestep = options.timesteps;
             } else {  // eo_clause?
-                temp_clauses = collect_primitives_for_all_timesteps(encoder, order_tag, options.timesteps - 1);
+                first_timestep = 0;
+                last_timestep = options.timesteps - 1;
             }
-            for (int k = 0; k < temp_clauses.size(); k++) {
-                result.push_back(std::make_tuple(temp_clauses[k], custom_order_counter));
+            for (int t = first_timestep; t <= last_timestep; t++) {
+                keys.push_back(std::make_tuple(order_tag, t));
+                key_order.push_back(custom_order_counter);
             }
             custom_order_counter++;  // increase counter for every group
         }
     }
+    return keys;
+}
+
+std::vector<std::tuple<int, int>> create_custom_clause_order_mapping(encoder_abstract &encoder, primitive_store &store,
+                                                                     option_values &options) {
+    LOG_MESSAGE(log_level::info) << "Calculating custom conjoin order";
+
+    // contains the result at the end
+    std::vector<std::tuple<int, int>> result;
+
+    // collect the (tag, timestep) pairs with their position in the partial order first,
+    // so the encoder can prepare all of them at once
+    std::vector<int> key_order;
+    std::vector<std::tuple<primitive_tag, int>> keys = create_custom_order_keys(options, key_order);
+
+    encoder.prepare_logic_primitives(keys);
+    for (int k = 0; k < keys.size(); k++) {
+        std::vector<logic_primitive> temp_clauses =
+            collect_primitives_for_single_timestep(encoder, std::get<0>(keys[k]), std::get<1>(keys[k]));
+        for (int id : store.add_primitives(temp_clauses)) {
+            result.push_back(std::make_tuple(id, key_order[k]));
+        }
+    }
     return result;
 }
 
-std::vector<std::tuple<logic_primitive, int>> create_force_clause_order_mapping(encoder::encoder_abstract &encoder,
-                                                                                option_values &options) {
+std::vector<std::tuple<int, int>> create_force_clause_order_mapping(encoder::encoder_abstract &encoder,
+                                                                    primitive_store &store, option_values &options) {
     LOG_MESSAGE(log_level::info) << "Calculating force conjoin order";
 
     // order the primitives by custom order
-    std::vector<std::tuple<logic_primitive, int>> all_primitives =
-        conjoin_order::create_custom_clause_order_mapping(encoder, options);
-    std::vector<logic_primitive> stripped_primitives;
+    std::vector<std::tuple<int, int>> all_primitives =
+        conjoin_order::create_custom_clause_order_mapping(encoder, store, options);
+    std::vector<int> stripped_primitives;
     for (int i = 0; i < all_primitives.size(); i++) {
         stripped_primitives.push_back(std::get<0>(all_primitives[i]));
     }
@@ -198,16 +226,11 @@ std::vector<std::tuple<logic_primitive, int>> create_force_clause_order_mapping(
     for (int i = 0; i < stripped_primitives.size(); i++) {
         initial_mapping[i] = i;
     }
-    // enable for random initial permutation
-    if (options.force_random_seed) {
-        auto rng = std::default_random_engine{};
-        std::shuffle(std::begin(initial_mapping), std::end(initial_mapping), rng);
-    }
+    variable_order::force_parameters parameters(options);
+    std::vector<int> force_order = variable_order::force_clause_order(
+        initial_mapping, store, stripped_primitives, encoder.m_symbol_map.get_num_variables() + 1, parameters);
 
-    std::vector<int> force_order = variable_order::force_clause_order(initial_mapping, stripped_primitives,
-                                                                      encoder.m_symbol_map.get_num_variables() + 1);
-
-    std::vector<std::tuple<logic_primitive, int>> result;
+    std::vector<std::tuple<int, int>> result;
     for (int i = 0; i < force_order.size(); i++) {
         result.push_back(std::make_tuple(stripped_primitives[force_order[i]], i));
     }
@@ -215,12 +238,13 @@ std::vector<std::tuple<logic_primitive, int>> create_force_clause_order_mapping(
     return result;
 }
 
-std::vector<std::tuple<logic_primitive, int>> create_bottom_up_clause_order_mapping(encoder::encoder_abstract &encoder,
-                                                                                    option_values &options) {
+std::vector<std::tuple<int, int>> create_bottom_up_clause_order_mapping(encoder::encoder_abstract &encoder,
+                                                                        primitive_store &store,
+                                                                        option_values &options) {
     LOG_MESSAGE(log_level::info) << "Calculating bottom up conjoin order";
 
-    std::vector<std::tuple<logic_primitive, int>> custom_order = create_custom_clause_order_mapping(encoder, options);
-    std::vector<logic_primitive> bottom_up_order;
+    std::vector<std::tuple<int, int>> custom_order = create_custom_clause_order_mapping(encoder, store, options);
+    std::vector<int> bottom_up_order;
     for (int i = 0; i < custom_order.size(); i++) {
         bottom_up_order.push_back(std::get<0>(custom_order[i]));
     }
@@ -231,35 +255,35 @@ std::vector<std::tuple<logic_primitive, int>> create_bottom_up_clause_order_mapp
         var_to_pos[pos_to_var[i]] = i;
     }
 
-    sort_bottom_up(bottom_up_order, 0, bottom_up_order.size(), var_to_pos);
+    sort_bottom_up(store, bottom_up_order, 0, bottom_up_order.size(), var_to_pos);
 
-    std::vector<std::tuple<logic_primitive, int>> result;
+    std::vector<std::tuple<int, int>> result;
     for (int i = 0; i < bottom_up_order.size(); i++) {
         result.push_back(std::make_tuple(bottom_up_order[i], i));
     }
     return result;
 }
 
-std::vector<std::tuple<logic_primitive, int, int>> create_mixed_clause_order_mapping(
-    std::vector<std::tuple<planning_logic::logic_primitive, int>> &order,
-    std::vector<std::tuple<planning_logic::logic_primitive, int>> &tiebreaker) {
+std::vector<std::tuple<int, int, int>> create_mixed_clause_order_mapping(std::vector<std::tuple<int, int>> &order,
+                                                                         std::vector<std::tuple<int, int>> &tiebreaker,
+                                                                         int num_primitives) {
     LOG_MESSAGE(log_level::info) << "Calculating mixed conjoin order";
 
     // combine tuples to triples
-    std::vector<std::tuple<logic_primitive, int, int>> combined_order;
-    std::map<logic_primitive, int> clause_order_map;  // helper map, maps var index to custom order
+    std::vector<std::tuple<int, int, int>> combined_order;
+    std::vector<int> clause_order_map(num_primitives);  // helper map, maps primitive id to custom order
     for (int i = 0; i < order.size(); i++) {
         clause_order_map[std::get<0>(order[i])] = std::get<1>(order[i]);
     }
     for (int i = 0; i < tiebreaker.size(); i++) {
-        logic_primitive force_primitive = std::get<0>(tiebreaker[i]);
-        int force_idx = std::get<1>(tiebreaker[i]);
-        combined_order.push_back(std::make_tuple(force_primitive, clause_order_map[force_primitive], force_idx));
+        int id = std::get<0>(tiebreaker[i]);
+        int tiebreak_idx = std::get<1>(tiebreaker[i]);
+        combined_order.push_back(std::make_tuple(id, clause_order_map[id], tiebreak_idx));
     }
 
     // sort by custom order and use force order as tiebreaker
     sort(combined_order.begin(), combined_order.end(),
-         [](const std::tuple<logic_primitive, int, int> &lhs, const std::tuple<logic_primitive, int, int> &rhs) {
+         [](const std::tuple<int, int, int> &lhs, const std::tuple<int, int, int> &rhs) {
              if (std::get<1>(lhs) == std::get<1>(rhs)) {
                  return std::get<2>(lhs) < std::get<2>(rhs);
              } else {
@@ -291,6 +315,7 @@ std::vector<logic_primitive> order_clauses_for_layer(encoder_abstract &encoder,
         result_clauses.insert(result_clauses.end(), temp_clauses.begin(), temp_clauses.end());
     }
 
+    encoder.clear_primitive_cache();
     LOG_MESSAGE(log_level::info) << "Ordered a total of " << result_clauses.size() << " clauses for single layer "
                                  << layer;
     return result_clauses;
@@ -316,10 +341,25 @@ std::vector<logic_primitive> order_clauses_for_foundation(encoder_abstract &enco
         result_clauses.insert(result_clauses.end(), temp_clauses.begin(), temp_clauses.end());
     }
 
+    encoder.clear_primitive_cache();
     LOG_MESSAGE(log_level::info) << "Ordered a total of " << result_clauses.size() << " clauses for foundation";
     return result_clauses;
 }
 
+primitive_stream::primitive_stream(encoder_abstract &encoder, option_values &options) : m_encoder(encoder) {
+    std::vector<int> key_order;
+    m_keys = create_custom_order_keys(options, key_order);
+}
+
+bool primitive_stream::next(std::vector<logic_primitive> &primitives) {
+    if (m_next >= m_keys.size()) {
+        return false;
+    }
+    primitives = m_encoder.take_logic_primitives(std::get<0>(m_keys[m_next]), std::get<1>(m_keys[m_next]));
+    m_next++;
+    return true;
+}
+
 std::vector<logic_primitive> collect_primitives_for_all_timesteps(encoder_abstract &encoder,
                                                                   primitive_tag primitive_type, int timesteps) {
     std::vector<logic_primitive> result_primitives;
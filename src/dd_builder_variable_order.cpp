@@ -18,7 +18,8 @@ namespace variable_order {
 std::map<char, std::vector<variable_tag>> char_tag_map = {
     {'v', {variable_plan_var, variable_plan_binary_var}},
     {'o', {variable_plan_op, variable_plan_binary_op}},
-    {'h', {variable_h_amost_variable, variable_h_amost_operator, variable_h_amost_mutex}},
+    {'h', {variable_h_amost_variable, variable_h_amost_operator, variable_h_amost_mutex, variable_h_exists_step,
+           variable_h_symmetry}},
 };
 
 bool is_valid_variable_order_string(std::string variable_order) {
@@ -46,11 +47,10 @@ categorized_variables categorize_variables(planning_logic::plan_to_cnf_map &symb
     }
 
     // iterate over every variable of the cnf problem
-    for (std::map<tagged_variable, int>::iterator iter = symbol_map.m_variable_map.begin();
-         iter != symbol_map.m_variable_map.end(); iter++) {
+    for (std::tuple<tagged_variable, int> &entry : symbol_map.get_variables_in_key_order()) {
         // get information about the variable
-        tagged_variable tag_var = iter->first;
-        int cnf_index = iter->second;
+        tagged_variable tag_var = std::get<0>(entry);
+        int cnf_index = std::get<1>(entry);
         variable_tag tag = std::get<0>(tag_var);
         int timestep = std::get<1>(tag_var);
         tagged_variables[tag][timestep].push_back(cnf_index);
@@ -142,7 +142,7 @@ std::vector<std::tuple<int, int>> create_custom_var_order_mapping(encoder::encod
     LOG_MESSAGE(log_level::info) << "Calculating custom variable order";
 
     // calculate order given by order string
-    int custom_order_counter;  // counter that implies the partial order
+    int custom_order_counter = 0;  // counter that implies the partial order
     std::vector<std::tuple<int, int>> result;
     result.push_back(std::make_tuple(0, custom_order_counter));  // o variable at first position
     custom_order_counter++;
@@ -156,6 +156,11 @@ std::vector<std::tuple<int, int>> create_custom_var_order_mapping(encoder::encod
     // categorize the variables
     categorized_variables tagged_variables = categorize_variables(encoder.m_symbol_map, options.timesteps);
 
+    // variables without a planning meaning (the false variable of the reachability pruning) follow the 0 variable
+    for (int k = 0; k < tagged_variables[variable_none][0].size(); k++) {
+        result.push_back(std::make_tuple(tagged_variables[variable_none][0][k], 0));
+    }
+
     for (int i = 0; i < disjoin_order.size(); i++) {
         char current_char = disjoin_order[i];
 
@@ -200,9 +205,10 @@ std::vector<std::tuple<int, int>> create_force_var_order_mapping(encoder::encode
     LOG_MESSAGE(log_level::info) << "Calculating force variable order";
 
     // collect all logic primitives of the planning problem
-    std::vector<std::tuple<logic_primitive, int>> all_primitives =
-        conjoin_order::create_custom_clause_order_mapping(encoder, options);
-    std::vector<logic_primitive> stripped_primitives;
+    primitive_store store;
+    std::vector<std::tuple<int, int>> all_primitives =
+        conjoin_order::create_custom_clause_order_mapping(encoder, store, options);
+    std::vector<int> stripped_primitives;
     for (int i = 0; i < all_primitives.size(); i++) {
         stripped_primitives.push_back(std::get<0>(all_primitives[i]));
     }
@@ -214,15 +220,10 @@ std::vector<std::tuple<int, int>> create_force_var_order_mapping(encoder::encode
         initial_order[i] = i;
     }
 
-    // enable for random initial permutation
-    if (options.force_random_seed) {
-        auto rng = std::default_random_engine{};
-        std::shuffle(std::begin(initial_order), std::end(initial_order), rng);
-    }
-
     // calculate force order
     LOG_MESSAGE(log_level::info) << "Apllying force algorithm";
-    std::vector<int> force_order = force_variable_order(initial_order, stripped_primitives);
+    force_parameters parameters(options);
+    std::vector<int> force_order = force_variable_order(initial_order, store, stripped_primitives, parameters);
 
     LOG_MESSAGE(log_level::info) << "Transforming to result";
     std::vector<std::tuple<int, int>> result;
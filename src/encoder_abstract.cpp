@@ -0,0 +1,262 @@
+#include "encoder_abstract.h"
+
+#include <map>
+#include <memory>
+
+#include "logging.h"
+#include "preprocessing.h"
+#include "reachability.h"
+#include "thread_pool.h"
+
+using namespace planning_logic;
+
+namespace encoder {
+
+void encoder_abstract::set_up_reachability_pruning() {
+    if (m_options.binary_parallel) {
+        // the binary parallel encoding does not constrain all state variables, pruning them would change its count
+        LOG_MESSAGE(log_level::warning) << "Reachability pruning is not supported by the binary parallel encoder";
+        return;
+    }
+    std::shared_ptr<reachability::timestep_reachability> reachable =
+        std::make_shared<reachability::timestep_reachability>(m_sas_problem, m_options.timesteps);
+    m_symbol_map.set_impossible_variables([reachable](variable_tag tag, int timestep, int var_index, int value) {
+        if (tag == variable_plan_var) {
+            return !reachable->is_fact_possible(timestep, var_index, value);
+        }
+        if (tag == variable_plan_op) {
+            return !reachable->is_operator_possible(timestep, var_index);
+        }
+        return false;
+    });
+}
+
+void encoder_abstract::choose_variable_encodings() {
+    operator_index &index = m_sas_problem.m_index;
+    // number of preconditions and effects of every variable
+    std::vector<int> occurrences(m_sas_problem.m_variabels.size(), 0);
+    for (int p = 0; p < index.m_pre_vars.size(); p++) {
+        occurrences[index.m_pre_vars[p]]++;
+    }
+    for (int eff = 0; eff < index.m_effect_vars.size(); eff++) {
+        occurrences[index.m_effect_vars[eff]]++;
+    }
+
+    // number of binary and unary encoded variables per range, for the log
+    std::map<int, std::pair<int, int>> choices_per_range;
+    int num_binary = 0;
+    for (int var = 0; var < m_sas_problem.m_variabels.size(); var++) {
+        int range = m_sas_problem.m_variabels[var].m_range;
+        int bits = m_symbol_map.num_bits_for_binary_var(range);
+        // literals per timestep that grow with the encoding of the variable
+        // unary: at least one value is true, at most one value is true (quadratic if built pairwise), one literal
+        // per precondition and effect and two literals per value in the frame axioms
+        int unary_amo_cost = range * (range - 1);
+        if (m_options.exact_one_constraint || m_options.amo_constraint) {
+            unary_amo_cost = range;
+        } else if (m_options.use_ladder_encoding && range > 5) {
+            unary_amo_cost = 6 * (range - 1);
+        }
+        int unary_cost = range + unary_amo_cost + occurrences[var] + 2 * range;
+        // binary: every precondition and effect sets all bits and the unused codes are excluded. The frame axioms
+        // of the values share their bit nodes in the dd, they are not charged
+        int binary_cost = occurrences[var] * bits + ((1 << bits) - range) * bits;
+        // a variable with a single value has no bits in the binary encoding, it stays unary
+        // ties go to the binary encoding, it needs fewer dd variables
+        m_binary_variables[var] = range > 1 && binary_cost <= unary_cost;
+        num_binary += m_binary_variables[var];
+        if (m_binary_variables[var]) {
+            choices_per_range[range].first++;
+        } else {
+            choices_per_range[range].second++;
+        }
+    }
+    LOG_MESSAGE(log_level::info) << "Adaptive encoding uses the binary encoding for " << num_binary << " of "
+                                 << m_sas_problem.m_variabels.size() << " variables";
+    for (auto &choice : choices_per_range) {
+        LOG_MESSAGE(log_level::info) << "Adaptive encoding for range " << choice.first << ": " << choice.second.first
+                                     << " binary, " << choice.second.second << " unary";
+    }
+}
+
+bool encoder_abstract::is_timestep_invariant(primitive_tag tag) {
+    if (m_options.reachability_pruning) {
+        // the pruned variables differ between the timesteps
+        return false;
+    }
+    if (m_options.commutation_reduction && tag == eo_op) {
+        // the first timestep has no predecessor to be ordered with
+        return false;
+    }
+    // the initial state only exists for timestep 0
+    return tag != ini_state && tag != none;
+}
+
+std::vector<logic_primitive> encoder_abstract::get_logic_primitives(primitive_tag tag, int timestep) {
+    std::tuple<primitive_tag, int> key = std::make_tuple(tag, timestep);
+    auto cached = m_primitive_cache.find(key);
+    if (cached != m_primitive_cache.end()) {
+        return cached->second;
+    }
+
+    std::vector<logic_primitive> result;
+    auto primitive_template = m_templates.find(tag);
+    if (primitive_template != m_templates.end() && is_timestep_invariant(tag)) {
+        // derive the primitives from the template
+        int t_diff = timestep - primitive_template->second.m_timestep;
+        std::vector<int> variables = reserve_shifted_variables(primitive_template->second, t_diff);
+        result = instantiate_template(primitive_template->second, variables, t_diff);
+    } else {
+        result = construct_logic_primitives(tag, timestep);
+        int false_variable = m_symbol_map.get_false_variable();
+        if (false_variable != 0) {
+            result = preprocessing::assign_false(result, false_variable);
+            if (tag == ini_state) {
+                result.push_back(logic_primitive(logic_clause, ini_state, timestep, std::vector<int>(1, -false_variable)));
+            }
+        }
+        if (is_timestep_invariant(tag)) {
+            m_templates[tag] = create_template(result, timestep);
+        }
+    }
+
+    m_primitive_cache[key] = result;
+    return result;
+}
+
+void encoder_abstract::prepare_logic_primitives(const std::vector<std::tuple<primitive_tag, int>> &keys) {
+    // the templates and the variables are created sequentially in the order of the keys,
+    // so the variable indices are the same as without preparing
+    std::vector<std::tuple<primitive_tag, int>> shifted_keys;
+    std::vector<std::vector<int>> shifted_variables;
+    for (const std::tuple<primitive_tag, int> &key : keys) {
+        if (m_primitive_cache.find(key) != m_primitive_cache.end()) {
+            continue;
+        }
+        primitive_tag tag = std::get<0>(key);
+        auto primitive_template = m_templates.find(tag);
+        if (primitive_template == m_templates.end() || !is_timestep_invariant(tag)) {
+            get_logic_primitives(tag, std::get<1>(key));
+            continue;
+        }
+        int t_diff = std::get<1>(key) - primitive_template->second.m_timestep;
+        shifted_keys.push_back(key);
+        shifted_variables.push_back(reserve_shifted_variables(primitive_template->second, t_diff));
+        // reserve the key, so that duplicates in keys are only shifted once
+        m_primitive_cache[key];
+    }
+
+    // the shifting does not access the symbol map and can run in parallel
+    std::vector<std::vector<logic_primitive>> shifted(shifted_keys.size());
+    thread_pool pool(m_options.num_threads);
+    pool.parallel_for(shifted_keys.size(), [&](int i) {
+        const primitive_template &primitive_template = m_templates.at(std::get<0>(shifted_keys[i]));
+        int t_diff = std::get<1>(shifted_keys[i]) - primitive_template.m_timestep;
+        shifted[i] = instantiate_template(primitive_template, shifted_variables[i], t_diff);
+    });
+
+    for (int i = 0; i < shifted_keys.size(); i++) {
+        m_primitive_cache[shifted_keys[i]] = std::move(shifted[i]);
+    }
+    LOG_MESSAGE(log_level::info) << "Prepared the primitives for " << shifted_keys.size() << " timesteps with "
+                                 << pool.num_threads() << " threads";
+}
+
+std::vector<logic_primitive> encoder_abstract::combine_frame_to_transitions(
+    const std::vector<logic_primitive> &frame_primitives, int timestep) {
+    std::vector<logic_primitive> result;
+
+    int next = 0;
+    for (int v = 0; v < m_sas_problem.m_variabels.size(); v++) {
+        std::vector<std::vector<int>> dnfs;
+        std::vector<int> dnf_offsets;
+        for (int val = 0; val < m_sas_problem.m_variabels[v].m_range; val++) {
+            const logic_primitive &primitive = frame_primitives[next++];
+            dnf_offsets.push_back(dnfs.size());
+            if (primitive.m_type == logic_clause) {
+                for (int l : primitive.m_data) {
+                    dnfs.push_back(std::vector<int>(1, l));
+                }
+            } else {
+                dnfs.insert(dnfs.end(), primitive.m_dnf_data.begin(), primitive.m_dnf_data.end());
+            }
+        }
+        dnf_offsets.push_back(dnfs.size());
+        result.push_back(logic_primitive(logic_transition, frame, timestep, dnfs, dnf_offsets));
+    }
+    return result;
+}
+
+std::vector<logic_primitive> encoder_abstract::take_logic_primitives(primitive_tag tag, int timestep) {
+    std::vector<logic_primitive> result = get_logic_primitives(tag, timestep);
+    m_primitive_cache.erase(std::make_tuple(tag, timestep));
+    return result;
+}
+
+void encoder_abstract::clear_primitive_cache() {
+    // the templates are stored separately, so all derived primitives can be freed
+    m_primitive_cache.clear();
+}
+
+encoder_abstract::primitive_template encoder_abstract::create_template(const std::vector<logic_primitive> &primitives,
+                                                                       int timestep) {
+    primitive_template result;
+    result.m_timestep = timestep;
+    result.m_variables.push_back(0);
+    result.m_local_primitives = primitives;
+
+    // cnf index -> local id
+    std::map<int, int> local_ids;
+    auto to_local = [&](int &l) {
+        int variable = std::abs(l);
+        auto it = local_ids.find(variable);
+        int local_id;
+        if (it == local_ids.end()) {
+            local_id = result.m_variables.size();
+            local_ids[variable] = local_id;
+            result.m_variables.push_back(variable);
+        } else {
+            local_id = it->second;
+        }
+        l = l < 0 ? -local_id : local_id;
+    };
+
+    for (logic_primitive &primitive : result.m_local_primitives) {
+        for (int &l : primitive.m_data) {
+            to_local(l);
+        }
+        for (std::vector<int> &term : primitive.m_dnf_data) {
+            for (int &l : term) {
+                to_local(l);
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<int> encoder_abstract::reserve_shifted_variables(const primitive_template &primitive_template,
+                                                             int t_diff) {
+    std::vector<int> result(primitive_template.m_variables.size());
+    for (int i = 1; i < primitive_template.m_variables.size(); i++) {
+        result[i] = m_symbol_map.get_shifted_variable_index(primitive_template.m_variables[i], t_diff);
+    }
+    return result;
+}
+
+std::vector<logic_primitive> encoder_abstract::instantiate_template(const primitive_template &primitive_template,
+                                                                    const std::vector<int> &variables, int t_diff) {
+    std::vector<logic_primitive> result = primitive_template.m_local_primitives;
+    for (logic_primitive &primitive : result) {
+        primitive.m_timestep += t_diff;
+        for (int &l : primitive.m_data) {
+            l = l < 0 ? -variables[-l] : variables[l];
+        }
+        for (std::vector<int> &term : primitive.m_dnf_data) {
+            for (int &l : term) {
+                l = l < 0 ? -variables[-l] : variables[l];
+            }
+        }
+    }
+    return result;
+}
+}  // namespace encoder
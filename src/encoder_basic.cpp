@@ -11,9 +11,7 @@ using namespace planning_logic;
 namespace encoder {
 
 // have to see how advanced binary encoding goes
-std::vector<logic_primitive> encoder_basic::get_logic_primitives(primitive_tag tag, int timestep) {
-    update_timesteps(timestep);
-
+std::vector<logic_primitive> encoder_basic::construct_logic_primitives(primitive_tag tag, int timestep) {
     // std::cout << "Num Vars: " << m_symbol_map.get_num_variables() << " timestep: " << timestep << std::endl;
 
     switch (tag) {
@@ -48,14 +46,11 @@ int encoder_basic::num_variables_in_t_timesteps(int t) {
     int num_op_vars = 0;
 
     // calculate num variables
-    if (m_options.binary_variables) {
-        for (int var = 0; var < m_sas_problem.m_variabels.size(); var++) {
-            int var_size = m_sas_problem.m_variabels[var].m_range;
+    for (int var = 0; var < m_sas_problem.m_variabels.size(); var++) {
+        int var_size = m_sas_problem.m_variabels[var].m_range;
+        if (is_binary_variable(var)) {
             num_var_vars += m_symbol_map.num_bits_for_binary_var(var_size);
-        }
-    } else {
-        for (int var = 0; var < m_sas_problem.m_variabels.size(); var++) {
-            int var_size = m_sas_problem.m_variabels[var].m_range;
+        } else {
             num_var_vars += var_size;
         }
     }
@@ -91,7 +86,7 @@ std::vector<logic_primitive> encoder_basic::prebuild_goals(int t) {
             int goal_val = goal_pair.second;
             int goal_var_size = m_sas_problem.m_variabels[goal_var].m_range;
 
-            if (m_options.binary_variables) {
+            if (is_binary_variable(goal_var)) {
                 std::vector<int> goal_encoding =
                     m_symbol_map.get_variable_index_for_var_binary(i, goal_var, goal_val, goal_var_size);
                 for (int v : goal_encoding) {
@@ -114,7 +109,7 @@ std::vector<logic_primitive> encoder_basic::construct_initial_state() {
     std::vector<logic_primitive> result;
 
     for (int var = 0; var < m_sas_problem.m_variabels.size(); var++) {
-        if (m_options.binary_variables) {
+        if (is_binary_variable(var)) {
             int var_size = m_sas_problem.m_variabels[var].m_range;
             int var_val = m_sas_problem.m_initial_state[var];
             std::vector<int> var_encoding = m_symbol_map.get_variable_index_for_var_binary(0, var, var_val, var_size);
@@ -139,6 +134,14 @@ std::vector<logic_primitive> encoder_basic::construct_initial_state() {
         }
     }
 
+    // no object is touched before the first timestep
+    for (int c = 0; c < m_sas_problem.m_object_classes.size(); c++) {
+        for (int i = 0; i + 1 < m_sas_problem.m_object_classes[c].m_objects.size(); i++) {
+            int touched = m_symbol_map.get_variable_index(variable_h_symmetry, 0, c, i);
+            result.push_back(logic_primitive(logic_clause, ini_state, 0, std::vector<int>(1, -touched)));
+        }
+    }
+
     return result;
 }
 
@@ -152,7 +155,7 @@ std::vector<logic_primitive> encoder_basic::construct_goal(int timestep) {
         int goal_val = goal_pair.second;
         int goal_var_size = m_sas_problem.m_variabels[goal_var].m_range;
 
-        if (m_options.binary_variables) {
+        if (is_binary_variable(goal_var)) {
             std::vector<int> goal_encoding =
                 m_symbol_map.get_variable_index_for_var_binary(timestep, goal_var, goal_val, goal_var_size);
             for (int v : goal_encoding) {
@@ -177,12 +180,12 @@ std::vector<logic_primitive> encoder_basic::construct_goal(int timestep) {
 std::vector<logic_primitive> encoder_basic::construct_exact_one_value(int timestep) {
     std::vector<logic_primitive> result;
 
-    if (m_options.binary_variables) {
-        // if (m_options.binary_exclude_impossible)
-        //  we have to disallow impossible values here (it is not an option not to do it)
-        //  this is because the frame clause make no restrictions to impossible variable values
+    for (int v = 0; v < m_sas_problem.m_variabels.size(); v++) {
+        if (is_binary_variable(v)) {
+            // if (m_options.binary_exclude_impossible)
+            //  we have to disallow impossible values here (it is not an option not to do it)
+            //  this is because the frame clause make no restrictions to impossible variable values
 
-        for (int v = 0; v < m_sas_problem.m_variabels.size(); v++) {
             // iterate over the indizes that represent imposssible variable values
             int var_size = m_sas_problem.m_variabels[v].m_range;
             int num_imp_vars = (1 << m_symbol_map.num_bits_for_binary_var(var_size));
@@ -195,9 +198,7 @@ std::vector<logic_primitive> encoder_basic::construct_exact_one_value(int timest
                 }
                 result.push_back(logic_primitive(logic_clause, eo_var, timestep, new_clause));
             }
-        }
-    } else if (m_options.exact_one_constraint) {
-        for (int v = 0; v < m_sas_problem.m_variabels.size(); v++) {
+        } else if (m_options.exact_one_constraint) {
             std::vector<int> exact_one_should_be_true;
             for (int val = 0; val < m_sas_problem.m_variabels[v].m_range; val++) {
                 int index = m_symbol_map.get_variable_index(variable_plan_var, timestep, v, val);
@@ -205,9 +206,7 @@ std::vector<logic_primitive> encoder_basic::construct_exact_one_value(int timest
             }
 
             result.push_back(logic_primitive(logic_eo, eo_var, timestep, exact_one_should_be_true));
-        }
-    } else {
-        for (int v = 0; v < m_sas_problem.m_variabels.size(); v++) {
+        } else {
             std::vector<int> exact_one_should_be_true;
             for (int val = 0; val < m_sas_problem.m_variabels[v].m_range; val++) {
                 int index = m_symbol_map.get_variable_index(variable_plan_var, timestep, v, val);
@@ -218,6 +217,10 @@ std::vector<logic_primitive> encoder_basic::construct_exact_one_value(int timest
             result.push_back(logic_primitive(logic_clause, eo_var, timestep, exact_one_should_be_true));
 
             // at most one true
+            if (m_options.amo_constraint) {
+                result.push_back(logic_primitive(logic_amo, eo_var, timestep, exact_one_should_be_true));
+                continue;
+            }
             std::vector<std::vector<int>> constrain_clauses =
                 generate_at_most_one_constraint(exact_one_should_be_true, variable_h_amost_variable, timestep);
             for (std::vector<int> constraint : constrain_clauses) {
@@ -271,6 +274,10 @@ std::vector<logic_primitive> encoder_basic::construct_exact_one_action(int times
         result.push_back(logic_primitive(logic_clause, eo_op, timestep, exact_one_should_be_true));
 
         // at most one true
+        if (m_options.amo_constraint) {
+            result.push_back(logic_primitive(logic_amo, eo_op, timestep, exact_one_should_be_true));
+            return result;
+        }
         std::vector<std::vector<int>> constrain_clauses =
             generate_at_most_one_constraint(exact_one_should_be_true, variable_h_amost_operator, timestep);
         for (std::vector<int> constraint : constrain_clauses) {
@@ -278,6 +285,70 @@ std::vector<logic_primitive> encoder_basic::construct_exact_one_action(int times
         }
     }
 
+    if (m_options.symmetry_breaking) {
+        std::vector<logic_primitive> breaking = construct_symmetry_breaking(timestep);
+        result.insert(result.end(), breaking.begin(), breaking.end());
+    }
+    if (m_options.commutation_reduction && timestep > 0) {
+        std::vector<logic_primitive> order = construct_commutation_order(timestep);
+        result.insert(result.end(), order.begin(), order.end());
+    }
+    return result;
+}
+
+std::vector<logic_primitive> encoder_basic::construct_symmetry_breaking(int timestep) {
+    std::vector<logic_primitive> result;
+
+    for (int c = 0; c < m_sas_problem.m_object_classes.size(); c++) {
+        std::vector<std::vector<int>> &touching = m_sas_problem.m_object_classes[c].m_touching_operators;
+        for (int i = 0; i < touching.size(); i++) {
+            std::vector<int> op_indizes;
+            for (int op : touching[i]) {
+                op_indizes.push_back(m_symbol_map.get_variable_index(variable_plan_op, timestep, op));
+            }
+            if (i > 0) {
+                int previous = m_symbol_map.get_variable_index(variable_h_symmetry, timestep, c, i - 1);
+                for (int op_index : op_indizes) {
+                    result.push_back(
+                        logic_primitive(logic_clause, eo_op, timestep, std::vector<int>{-op_index, previous}));
+                }
+            }
+            // the last object is never needed for a later one
+            if (i == touching.size() - 1) {
+                continue;
+            }
+            int before = m_symbol_map.get_variable_index(variable_h_symmetry, timestep, c, i);
+            int after = m_symbol_map.get_variable_index(variable_h_symmetry, timestep + 1, c, i);
+            result.push_back(logic_primitive(logic_clause, eo_op, timestep, std::vector<int>{-before, after}));
+            std::vector<int> definition{-after, before};
+            for (int op_index : op_indizes) {
+                result.push_back(logic_primitive(logic_clause, eo_op, timestep, std::vector<int>{-op_index, after}));
+                definition.push_back(op_index);
+            }
+            result.push_back(logic_primitive(logic_clause, eo_op, timestep, definition));
+        }
+    }
+    return result;
+}
+
+std::vector<logic_primitive> encoder_basic::construct_commutation_order(int timestep) {
+    std::vector<logic_primitive> result;
+
+    for (int op2 = 0; op2 < m_sas_problem.m_operators.size(); op2++) {
+        std::vector<int> consequent;
+        for (int op1 : m_commuting_operators[op2]) {
+            if (op1 > op2) {
+                consequent.push_back(-m_symbol_map.get_variable_index(variable_plan_op, timestep - 1, op1));
+            }
+        }
+        if (consequent.empty()) {
+            continue;
+        }
+        std::vector<std::vector<int>> implication;
+        implication.push_back(std::vector<int>{m_symbol_map.get_variable_index(variable_plan_op, timestep, op2)});
+        implication.push_back(consequent);
+        result.push_back(logic_primitive(logic_implication, eo_op, timestep, implication));
+    }
     return result;
 }
 
@@ -306,10 +377,14 @@ std::vector<logic_primitive> encoder_basic::construct_no_conflicting_operators(i
 std::vector<logic_primitive> encoder_basic::construct_precondition(int timestep) {
     std::vector<logic_primitive> result;
 
+    if (m_options.group_pre_eff) {
+        return construct_grouped_precondition_effect(timestep);
+    }
+
     for (int op = 0; op < m_sas_problem.m_operators.size(); op++) {
         // one dnf for all preconditions and effects and one dnf for copying for every single precon
         std::vector<std::vector<int>> default_dnf;
-        int unary_op_idx;
+        int unary_op_idx = 0;
         if (m_options.binary_encoding) {
             std::vector<int> op_indizes = m_symbol_map.get_variable_index_for_op_binary(timestep, op);
             for (int o : op_indizes) {
@@ -327,11 +402,12 @@ std::vector<logic_primitive> encoder_basic::construct_precondition(int timestep)
             default_dnf.push_back(tmp);
         }
 
-        for (int eff = 0; eff < m_sas_problem.m_operators[op].m_effects.size(); eff++) {
+        operator_index &index = m_sas_problem.m_index;
+        for (int eff = index.m_effect_offsets[op]; eff < index.m_effect_offsets[op + 1]; eff++) {
             std::vector<std::vector<int>> new_dnf = default_dnf;
             int effected_var, effected_old_val, effected_var_size;
-            effected_var = std::get<0>(m_sas_problem.m_operators[op].m_effects[eff]);
-            effected_old_val = std::get<1>(m_sas_problem.m_operators[op].m_effects[eff]);
+            effected_var = index.m_effect_vars[eff];
+            effected_old_val = index.m_effect_pres[eff];
             effected_var_size = m_sas_problem.m_variabels[effected_var].m_range;
             if (effected_old_val == -1) {
                 // a value of -1 the value of the variable is irrelevant,
@@ -339,8 +415,9 @@ std::vector<logic_primitive> encoder_basic::construct_precondition(int timestep)
                 continue;
             }
 
-            int unary_precon_idx;
-            if (m_options.binary_variables) {
+            int unary_precon_idx = 0;
+            bool is_binary = is_binary_variable(effected_var);
+            if (is_binary) {
                 std::vector<int> var_indizes = m_symbol_map.get_variable_index_for_var_binary(
                     timestep, effected_var, effected_old_val, effected_var_size);
                 new_dnf.push_back(var_indizes);
@@ -354,7 +431,7 @@ std::vector<logic_primitive> encoder_basic::construct_precondition(int timestep)
                 new_dnf.push_back(tmp);
             }
 
-            if (!m_options.binary_encoding && !m_options.binary_variables) {
+            if (!m_options.binary_encoding && !is_binary) {
                 std::vector<int> new_clause;
                 new_clause.push_back(-unary_op_idx);
                 new_clause.push_back(unary_precon_idx);
@@ -368,21 +445,76 @@ std::vector<logic_primitive> encoder_basic::construct_precondition(int timestep)
     return result;
 }
 
+// If action a is applied at step t, then pre(a) holds at step t and eff(a) holds at step t + 1.
+std::vector<logic_primitive> encoder_basic::construct_grouped_precondition_effect(int timestep) {
+    std::vector<logic_primitive> result;
+    operator_index &index = m_sas_problem.m_index;
+
+    for (int op = 0; op < m_sas_problem.m_operators.size(); op++) {
+        std::vector<int> antecedent;
+        if (m_options.binary_encoding) {
+            antecedent = m_symbol_map.get_variable_index_for_op_binary(timestep, op);
+        } else {
+            antecedent.push_back(m_symbol_map.get_variable_index(variable_plan_op, timestep, op));
+        }
+
+        std::vector<int> consequent;
+        for (int eff = index.m_effect_offsets[op]; eff < index.m_effect_offsets[op + 1]; eff++) {
+            int effected_var = index.m_effect_vars[eff];
+            int effected_old_val = index.m_effect_pres[eff];
+            if (effected_old_val == -1) {
+                continue;
+            }
+            if (is_binary_variable(effected_var)) {
+                int effected_var_size = m_sas_problem.m_variabels[effected_var].m_range;
+                std::vector<int> var_indizes = m_symbol_map.get_variable_index_for_var_binary(
+                    timestep, effected_var, effected_old_val, effected_var_size);
+                consequent.insert(consequent.end(), var_indizes.begin(), var_indizes.end());
+            } else {
+                consequent.push_back(
+                    m_symbol_map.get_variable_index(variable_plan_var, timestep, effected_var, effected_old_val));
+            }
+        }
+        for (int eff = index.m_effect_offsets[op]; eff < index.m_effect_offsets[op + 1]; eff++) {
+            int effected_var = index.m_effect_vars[eff];
+            int effected_new_val = index.m_effect_posts[eff];
+            if (is_binary_variable(effected_var)) {
+                int effected_var_size = m_sas_problem.m_variabels[effected_var].m_range;
+                std::vector<int> var_indizes = m_symbol_map.get_variable_index_for_var_binary(
+                    timestep + 1, effected_var, effected_new_val, effected_var_size);
+                consequent.insert(consequent.end(), var_indizes.begin(), var_indizes.end());
+            } else {
+                consequent.push_back(
+                    m_symbol_map.get_variable_index(variable_plan_var, timestep + 1, effected_var, effected_new_val));
+            }
+        }
+
+        std::vector<std::vector<int>> implication;
+        implication.push_back(antecedent);
+        implication.push_back(consequent);
+        result.push_back(logic_primitive(logic_implication, precon, timestep, implication));
+    }
+
+    return result;
+}
+
 // If action a is applied at step t, then eff(a) hold at step t + 1.
 std::vector<logic_primitive> encoder_basic::construct_effect(int timestep) {
     std::vector<logic_primitive> result;
 
     if (m_options.group_pre_eff) {
+        // the effects are part of the precondition primitives
         return result;
     }
 
     for (int op = 0; op < m_sas_problem.m_operators.size(); op++) {
-        int unary_op_idx;
-        for (int eff = 0; eff < m_sas_problem.m_operators[op].m_effects.size(); eff++) {
-            int unary_eff_idx;
+        int unary_op_idx = 0;
+        operator_index &index = m_sas_problem.m_index;
+        for (int eff = index.m_effect_offsets[op]; eff < index.m_effect_offsets[op + 1]; eff++) {
+            int unary_eff_idx = 0;
             int effected_var, effected_new_val, effected_var_size;
-            effected_var = std::get<0>(m_sas_problem.m_operators[op].m_effects[eff]);
-            effected_new_val = std::get<2>(m_sas_problem.m_operators[op].m_effects[eff]);
+            effected_var = index.m_effect_vars[eff];
+            effected_new_val = index.m_effect_posts[eff];
             effected_var_size = m_sas_problem.m_variabels[effected_var].m_range;
 
             std::vector<std::vector<int>> new_dnf;
@@ -404,7 +536,8 @@ std::vector<logic_primitive> encoder_basic::construct_effect(int timestep) {
                 new_dnf.push_back(tmp);
             }
 
-            if (m_options.binary_variables) {
+            bool is_binary = is_binary_variable(effected_var);
+            if (is_binary) {
                 std::vector<int> var_indizes = m_symbol_map.get_variable_index_for_var_binary(
                     timestep + 1, effected_var, effected_new_val, effected_var_size);
                 new_dnf.push_back(var_indizes);
@@ -418,7 +551,7 @@ std::vector<logic_primitive> encoder_basic::construct_effect(int timestep) {
                 new_dnf.push_back(tmp);
             }
 
-            if (!m_options.binary_encoding && !m_options.binary_variables) {
+            if (!m_options.binary_encoding && !is_binary) {
                 std::vector<int> new_clause;
                 new_clause.push_back(-unary_op_idx);
                 new_clause.push_back(unary_eff_idx);
@@ -443,27 +576,15 @@ std::vector<logic_primitive> encoder_basic::construct_frame(int timestep) {
             // find the actions that support this transition.
             // (planning) indizes of the actions that support the change of the variable
             // to become true in the next timestep
-            std::vector<int> support_become_true;
-            for (int op = 0; op < m_sas_problem.m_operators.size(); op++) {
-                for (int i = 0; i < m_sas_problem.m_operators[op].m_effects.size(); i++) {
-                    std::tuple<int, int, int> op_eff = m_sas_problem.m_operators[op].m_effects[i];
-                    int effected_var, val_pre, val_post;
-                    effected_var = std::get<0>(op_eff);
-                    val_pre = std::get<1>(op_eff);
-                    val_post = std::get<2>(op_eff);
-
-                    // check if corrected variable is affected, and it changes to ture
-                    if ((effected_var == v) && (val_post == val)) {
-                        support_become_true.push_back(op);
-                    }
-                }
-            }
+            std::vector<int> support_become_true(m_sas_problem.m_index.adders_begin(v, val),
+                                                 m_sas_problem.m_index.adders_end(v, val));
 
             std::vector<std::vector<int>> new_dnf;
-            int unary_val_t1, unary_val_t2;
+            int unary_val_t1 = 0, unary_val_t2 = 0;
             std::vector<int> unary_op_idxs;
 
-            if (m_options.binary_variables) {
+            bool is_binary = is_binary_variable(v);
+            if (is_binary) {
                 std::vector<int> old_var_idzs, new_var_idzs;
                 old_var_idzs = m_symbol_map.get_variable_index_for_var_binary(timestep, v, val, var_size);
                 new_var_idzs = m_symbol_map.get_variable_index_for_var_binary(timestep + 1, v, val, var_size);
@@ -506,7 +627,7 @@ std::vector<logic_primitive> encoder_basic::construct_frame(int timestep) {
                 }
             }
 
-            if (!m_options.binary_encoding && !m_options.binary_variables) {
+            if (!m_options.binary_encoding && !is_binary) {
                 std::vector<int> new_clause;
                 new_clause.push_back(unary_val_t1);
                 new_clause.push_back(-unary_val_t2);
@@ -519,6 +640,10 @@ std::vector<logic_primitive> encoder_basic::construct_frame(int timestep) {
             }
         }
     }
+
+    if (m_options.transition_frame) {
+        return combine_frame_to_transitions(result, timestep);
+    }
     return result;
 }
 
@@ -533,6 +658,20 @@ std::vector<logic_primitive> encoder_basic::construct_mutex(int timestep) {
     for (int m = 0; m < m_sas_problem.m_mutex_groups.size(); m++) {
         std::vector<std::pair<int, int>> at_most_one_should_be_true = m_sas_problem.m_mutex_groups[m];
 
+        bool is_unary = true;
+        for (std::pair<int, int> &fact : at_most_one_should_be_true) {
+            is_unary = is_unary && !is_binary_variable(fact.first);
+        }
+        if (m_options.amo_constraint && is_unary) {
+            // one primitive for the whole group
+            std::vector<int> literals;
+            for (std::pair<int, int> &fact : at_most_one_should_be_true) {
+                literals.push_back(m_symbol_map.get_variable_index(variable_plan_var, timestep, fact.first, fact.second));
+            }
+            result.push_back(logic_primitive(logic_amo, mutex, timestep, literals));
+            continue;
+        }
+
         for (int i = 0; i < at_most_one_should_be_true.size(); i++) {
             for (int j = i + 1; j < at_most_one_should_be_true.size(); j++) {
                 std::vector<int> new_clause;
@@ -544,17 +683,20 @@ std::vector<logic_primitive> encoder_basic::construct_mutex(int timestep) {
                 val2 = at_most_one_should_be_true[j].second;
                 size2 = m_sas_problem.m_variabels[var2].m_range;
 
-                if (m_options.binary_variables) {
+                if (is_binary_variable(var1)) {
                     // binary planning variables
                     for (int v : m_symbol_map.get_variable_index_for_var_binary(timestep, var1, val1, size1)) {
                         new_clause.push_back(-v);
                     }
+                } else {
+                    // unary planning variables
+                    new_clause.push_back(-m_symbol_map.get_variable_index(variable_plan_var, timestep, var1, val1));
+                }
+                if (is_binary_variable(var2)) {
                     for (int v : m_symbol_map.get_variable_index_for_var_binary(timestep, var2, val2, size2)) {
                         new_clause.push_back(-v);
                     }
                 } else {
-                    // unary planning variables
-                    new_clause.push_back(-m_symbol_map.get_variable_index(variable_plan_var, timestep, var1, val1));
                     new_clause.push_back(-m_symbol_map.get_variable_index(variable_plan_var, timestep, var2, val2));
                 }
 
@@ -620,9 +762,6 @@ std::vector<std::vector<int>> encoder_basic::generate_at_most_one_constraint_pai
     return all_new_clauses;
 }
 
-void encoder_basic::update_timesteps(int timestep) {
-    m_num_timesteps = timestep > m_num_timesteps ? timestep : m_num_timesteps;
-}
 
 // This call depends on the correct symbol map.
 std::vector<bool> encoder_basic::parse_cnf_solution(std::string filepath) {
@@ -674,7 +813,7 @@ std::string encoder_basic::decode_cnf_variable(int index) {
         case variable_plan_var:
             type = "plan_variable";
             name = m_sas_problem.m_variabels[v_index].m_name + ": " +
-                   m_sas_problem.m_variabels[v_index].m_symbolic_names[v_value];
+                   std::string(m_sas_problem.m_variabels[v_index].m_symbolic_names[v_value]);
             break;
         case variable_plan_op:
             type = "plan_action";
@@ -689,6 +828,12 @@ std::string encoder_basic::decode_cnf_variable(int index) {
         case variable_h_amost_mutex:
             type = "h_amost_mutex";
             break;
+        case variable_h_exists_step:
+            type = "h_exists_step";
+            break;
+        case variable_h_symmetry:
+            type = "h_symmetry";
+            break;
         default:
             type = "unknown";
     }
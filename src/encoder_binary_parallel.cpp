@@ -10,18 +10,13 @@ binary_parallel::binary_parallel(option_values &options, sas_problem &problem, g
 
     m_group_id = std::vector<int>(m_sas_problem.m_operators.size());
 
-    m_colouring = graph::approximate_colouring(conflict_graph);
-    m_num_colours = 0;
-    for (int i = 0; i < m_colouring.size(); i++) {
-        m_num_colours = m_colouring[i] > m_num_colours ? m_colouring[i] : m_num_colours;
-    }
-    m_num_colours++;
+    m_colouring = graph::improved_colouring(conflict_graph, options.colouring_time_budget);
+    m_num_colours = graph::num_colours(m_colouring);
 
     LOG_MESSAGE(log_level::info) << "Encoder found " << m_num_colours << " colour classes";
 
     m_colour_class_size = std::vector<int>(m_num_colours);
     for (int op = 0; op < m_sas_problem.m_operators.size(); op++) {
-        int op_col = m_colouring[op];
         m_group_id[op] = m_colour_class_size[m_colouring[op]];
         m_colour_class_size[m_colouring[op]]++;
     }
@@ -34,17 +29,45 @@ binary_parallel::binary_parallel(option_values &options, sas_problem &problem, g
     LOG_MESSAGE(log_level::info) << "Finished construction binary parallel encoder";
 }
 
-int binary_parallel::num_variables_in_t_timesteps(int t){
-    return 0;
-}
+int binary_parallel::num_variables_in_t_timesteps(int t) {
+    int num_var_vars = 0;
+    int num_op_vars = 0;
+
+    // every state variable is encoded binary
+    for (int var = 0; var < m_sas_problem.m_variabels.size(); var++) {
+        num_var_vars += m_symbol_map.num_bits_for_binary_var(m_sas_problem.m_variabels[var].m_range);
+    }
 
-std::vector<logic_primitive> binary_parallel::prebuild_goals(int t){
-    return std::vector<logic_primitive>();
+    // every colour class chooses one of its operators (or the noop) binary
+    for (int col = 0; col < m_num_colours; col++) {
+        num_op_vars += m_symbol_map.num_bits_for_binary_var(m_colour_class_size[col]);
+    }
+
+    // add one for the 0 variable that is included in every bdd
+    return (num_var_vars * (t + 1)) + (num_op_vars * t) + 1;
 }
 
-std::vector<logic_primitive> binary_parallel::get_logic_primitives(primitive_tag tag, int timestep) {
-    update_timesteps(timestep);
+std::vector<logic_primitive> binary_parallel::prebuild_goals(int t) {
+    std::vector<logic_primitive> result;
+    std::vector<std::vector<int>> dnf;
+
+    for (int i = 0; i <= t; i++) {
+        // variables that are necessary to fulfil the goal in t=i
+        std::vector<int> goal_i;
+        for (std::pair<int, int> &goal_pair : m_sas_problem.m_goal) {
+            int goal_var_size = m_sas_problem.m_variabels[goal_pair.first].m_range;
+            std::vector<int> goal_encoding = m_symbol_map.get_variable_index_binary(
+                variable_plan_binary_var, i, goal_pair.first, goal_pair.second, goal_var_size);
+            goal_i.insert(goal_i.end(), goal_encoding.begin(), goal_encoding.end());
+        }
+        dnf.push_back(goal_i);
+    }
+
+    result.push_back(logic_primitive(logic_dnf, goal, -1, dnf));
+    return result;
+}
 
+std::vector<logic_primitive> binary_parallel::construct_logic_primitives(primitive_tag tag, int timestep) {
     // std::cout << "Num Vars: " << m_symbol_map.get_num_variables() << " timestep: " << timestep << std::endl;
 
     switch (tag) {
@@ -74,9 +97,6 @@ std::vector<logic_primitive> binary_parallel::get_logic_primitives(primitive_tag
     }
 }
 
-void binary_parallel::update_timesteps(int timestep) {
-    m_num_timesteps = timestep > m_num_timesteps ? timestep : m_num_timesteps;
-}
 
 std::vector<logic_primitive> binary_parallel::construct_initial_state() {
     std::vector<logic_primitive> result;
@@ -107,7 +127,7 @@ std::vector<logic_primitive> binary_parallel::construct_goal(int timestep) {
                                                                                 goal_var, goal_val, goal_var_size);
         std::vector<std::vector<int>> new_dnf;
         new_dnf.push_back(goal_encoding);
-        result.push_back(logic_primitive(logic_dnf, goal, 0, new_dnf));
+        result.push_back(logic_primitive(logic_dnf, goal, timestep, new_dnf));
     }
 
     return result;
@@ -243,12 +263,17 @@ std::vector<logic_primitive> binary_parallel::construct_mutex(int timestep) {
 std::vector<logic_primitive> binary_parallel::construct_precondition(int timestep) {
     std::vector<logic_primitive> result;
 
+    if (m_options.group_pre_eff) {
+        return construct_grouped_precondition_effect(timestep);
+    }
+
     for (int op = 0; op < m_sas_problem.m_operators.size(); op++) {
-        for (int eff = 0; eff < m_sas_problem.m_operators[op].m_effects.size(); eff++) {
+        operator_index &index = m_sas_problem.m_index;
+        for (int eff = index.m_effect_offsets[op]; eff < index.m_effect_offsets[op + 1]; eff++) {
             int op_col, effected_var, effected_old_val, effected_var_size;
             op_col = m_colouring[op];
-            effected_var = std::get<0>(m_sas_problem.m_operators[op].m_effects[eff]);
-            effected_old_val = std::get<1>(m_sas_problem.m_operators[op].m_effects[eff]);
+            effected_var = index.m_effect_vars[eff];
+            effected_old_val = index.m_effect_pres[eff];
             effected_var_size = m_sas_problem.m_variabels[effected_var].m_range;
 
             if (effected_old_val == -1) {
@@ -280,12 +305,18 @@ std::vector<logic_primitive> binary_parallel::construct_precondition(int timeste
 std::vector<logic_primitive> binary_parallel::construct_effect(int timestep) {
     std::vector<logic_primitive> result;
 
+    if (m_options.group_pre_eff) {
+        // the effects are part of the precondition primitives
+        return result;
+    }
+
     for (int op = 0; op < m_sas_problem.m_operators.size(); op++) {
-        for (int eff = 0; eff < m_sas_problem.m_operators[op].m_effects.size(); eff++) {
+        operator_index &index = m_sas_problem.m_index;
+        for (int eff = index.m_effect_offsets[op]; eff < index.m_effect_offsets[op + 1]; eff++) {
             int op_col, effected_var, effected_new_val, effected_var_size;
             op_col = m_colouring[op];
-            effected_var = std::get<0>(m_sas_problem.m_operators[op].m_effects[eff]);
-            effected_new_val = std::get<2>(m_sas_problem.m_operators[op].m_effects[eff]);
+            effected_var = index.m_effect_vars[eff];
+            effected_new_val = index.m_effect_posts[eff];
             effected_var_size = m_sas_problem.m_variabels[effected_var].m_range;
 
             std::vector<std::vector<int>> new_dnf;
@@ -302,12 +333,49 @@ std::vector<logic_primitive> binary_parallel::construct_effect(int timestep) {
                 variable_plan_binary_var, timestep + 1, effected_var, effected_new_val, effected_var_size);
             new_dnf.push_back(var_indizes);
 
-            result.push_back(logic_primitive(logic_dnf, precon, timestep, new_dnf));
+            result.push_back(logic_primitive(logic_dnf, effect, timestep, new_dnf));
         }
     }
     return result;
 }
 
+std::vector<logic_primitive> binary_parallel::construct_grouped_precondition_effect(int timestep) {
+    std::vector<logic_primitive> result;
+    operator_index &index = m_sas_problem.m_index;
+
+    for (int op = 0; op < m_sas_problem.m_operators.size(); op++) {
+        int op_col = m_colouring[op];
+        std::vector<int> antecedent = m_symbol_map.get_variable_index_binary(
+            variable_plan_binary_op, timestep, op_col, m_group_id[op], m_colour_class_size[op_col]);
+
+        std::vector<int> consequent;
+        for (int eff = index.m_effect_offsets[op]; eff < index.m_effect_offsets[op + 1]; eff++) {
+            int effected_var = index.m_effect_vars[eff];
+            int effected_old_val = index.m_effect_pres[eff];
+            if (effected_old_val == -1) {
+                continue;
+            }
+            std::vector<int> var_indizes =
+                m_symbol_map.get_variable_index_binary(variable_plan_binary_var, timestep, effected_var,
+                                                       effected_old_val, m_sas_problem.m_variabels[effected_var].m_range);
+            consequent.insert(consequent.end(), var_indizes.begin(), var_indizes.end());
+        }
+        for (int eff = index.m_effect_offsets[op]; eff < index.m_effect_offsets[op + 1]; eff++) {
+            int effected_var = index.m_effect_vars[eff];
+            std::vector<int> var_indizes = m_symbol_map.get_variable_index_binary(
+                variable_plan_binary_var, timestep + 1, effected_var, index.m_effect_posts[eff],
+                m_sas_problem.m_variabels[effected_var].m_range);
+            consequent.insert(consequent.end(), var_indizes.begin(), var_indizes.end());
+        }
+
+        std::vector<std::vector<int>> implication;
+        implication.push_back(antecedent);
+        implication.push_back(consequent);
+        result.push_back(logic_primitive(logic_implication, precon, timestep, implication));
+    }
+    return result;
+}
+
 std::vector<logic_primitive> binary_parallel::construct_frame(int timestep) {
     std::vector<logic_primitive> result;
 
@@ -318,21 +386,8 @@ std::vector<logic_primitive> binary_parallel::construct_frame(int timestep) {
             // find the actions that support this transition.
             // (planning) indizes of the actions that support the change of the variable
             // to become true in the next timestep
-            std::vector<int> support_become_true;
-            for (int op = 0; op < m_sas_problem.m_operators.size(); op++) {
-                for (int i = 0; i < m_sas_problem.m_operators[op].m_effects.size(); i++) {
-                    std::tuple<int, int, int> op_eff = m_sas_problem.m_operators[op].m_effects[i];
-                    int effected_var, val_pre, val_post;
-                    effected_var = std::get<0>(op_eff);
-                    val_pre = std::get<1>(op_eff);
-                    val_post = std::get<2>(op_eff);
-
-                    // check if corrected variable is affected, and it changes to ture
-                    if ((effected_var == v) && (val_post == val)) {
-                        support_become_true.push_back(op);
-                    }
-                }
-            }
+            std::vector<int> support_become_true(m_sas_problem.m_index.adders_begin(v, val),
+                                                 m_sas_problem.m_index.adders_end(v, val));
 
             std::vector<std::vector<int>> new_dnf;
             std::vector<int> old_var_idzs =
@@ -356,6 +411,10 @@ std::vector<logic_primitive> binary_parallel::construct_frame(int timestep) {
             result.push_back(logic_primitive(logic_dnf, frame, timestep, new_dnf));
         }
     }
+
+    if (m_options.transition_frame) {
+        return combine_frame_to_transitions(result, timestep);
+    }
     return result;
 }
 }  // namespace encoder
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "encoder_exists_step.h"
+
+using namespace planning_logic;
+
+namespace encoder {
+
+std::vector<logic_primitive> encoder_exists_step::construct_logic_primitives(primitive_tag tag, int timestep) {
+    if (tag == eo_op) {
+        return construct_exists_step_chains(timestep);
+    }
+    if (tag == effect) {
+        return construct_exists_step_effects(timestep);
+    }
+    return encoder_basic::construct_logic_primitives(tag, timestep);
+}
+
+std::vector<logic_primitive> encoder_exists_step::construct_exists_step_effects(int timestep) {
+    std::vector<logic_primitive> result;
+    operator_index &index = m_sas_problem.m_index;
+
+    for (int op = 0; op < m_sas_problem.m_operators.size(); op++) {
+        int op_index = m_symbol_map.get_variable_index(variable_plan_op, timestep, op);
+        for (int eff = index.m_effect_offsets[op]; eff < index.m_effect_offsets[op + 1]; eff++) {
+            int var = index.m_effect_vars[eff];
+            int post = index.m_effect_posts[eff];
+            if (index.m_effect_pres[eff] == post) {
+                continue;
+            }
+
+            if (is_binary_variable(var)) {
+                std::vector<std::vector<int>> dnf;
+                dnf.push_back(std::vector<int>{-op_index});
+                dnf.push_back(m_symbol_map.get_variable_index_for_var_binary(timestep + 1, var, post,
+                                                                             m_sas_problem.m_variabels[var].m_range));
+                result.push_back(logic_primitive(logic_dnf, effect, timestep, dnf));
+            } else {
+                int post_index = m_symbol_map.get_variable_index(variable_plan_var, timestep + 1, var, post);
+                result.push_back(logic_primitive(logic_clause, effect, timestep, std::vector<int>{-op_index, post_index}));
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<logic_primitive> encoder_exists_step::construct_exists_step_chains(int timestep) {
+    std::vector<logic_primitive> result;
+    operator_index &index = m_sas_problem.m_index;
+
+    for (int var = 0; var < m_sas_problem.m_variabels.size(); var++) {
+        for (int val = 0; val < m_sas_problem.m_variabels[var].m_range; val++) {
+            int fact = index.fact_id(var, val);
+            // both lists are sorted by operator
+            const int *deleter = index.deleters_begin(var, val);
+            const int *deleters_end = index.deleters_end(var, val);
+            const int *user = index.pre_users_begin(var, val);
+            const int *users_end = index.pre_users_end(var, val);
+
+            // literals that imply that a deleter with a lower index is part of the step
+            std::vector<int> pending;
+            int num_helpers = 0;
+            while (deleter != deleters_end || user != users_end) {
+                int op = deleter == deleters_end ? *user : (user == users_end ? *deleter : std::min(*deleter, *user));
+                int op_index = m_symbol_map.get_variable_index(variable_plan_op, timestep, op);
+
+                if (user != users_end && *user == op) {
+                    user++;
+                    if (pending.size() == 1) {
+                        // no helper variable is needed for a single deleter
+                        result.push_back(logic_primitive(logic_clause, eo_op, timestep,
+                                                         std::vector<int>{-pending[0], -op_index}));
+                    } else if (pending.size() > 1) {
+                        int helper = m_symbol_map.get_variable_index(variable_h_exists_step, timestep, fact, num_helpers++);
+                        // the helper is the disjunction of the pending literals. Defining it in both directions
+                        // keeps the number of models the same as without helper variables
+                        std::vector<int> definition{-helper};
+                        for (int p : pending) {
+                            result.push_back(
+                                logic_primitive(logic_clause, eo_op, timestep, std::vector<int>{-p, helper}));
+                            definition.push_back(p);
+                        }
+                        result.push_back(logic_primitive(logic_clause, eo_op, timestep, definition));
+                        result.push_back(
+                            logic_primitive(logic_clause, eo_op, timestep, std::vector<int>{-helper, -op_index}));
+                        pending = std::vector<int>{helper};
+                    }
+                }
+                // an operator that needs and deletes the fact only affects operators with a higher index
+                if (deleter != deleters_end && *deleter == op) {
+                    deleter++;
+                    pending.push_back(op_index);
+                }
+            }
+        }
+    }
+    return result;
+}
+}  // namespace encoder
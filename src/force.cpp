@@ -3,65 +3,170 @@
 #include <iostream>
 #include <algorithm>  // std::sort
 #include <cmath>      // std::log2
+#include <random>
 
 #include "logging.h"
+#include "thread_pool.h"
 
 
 namespace variable_order {
 
-std::vector<int> force_variable_order(std::vector<int> &initial_pos_to_idx,
-                                      std::vector<planning_logic::logic_primitive> &primitives) {
-    
-    std::vector<std::vector<int>> hyper_edges;
-    for (int p = 0; p < primitives.size(); p++) {
-        hyper_edges.push_back(primitives[p].get_affected_variables());
+// 1. every position is cut to a 32 bit fixed point key, the larger the positions the fewer fractional bits remain.
+//    The keys are radix sorted, starting with the nodes in index order. The radix sort is stable, so nodes with the
+//    same key stay in index order.
+// 2. nodes with the same key can still have different positions. Every run of equal keys that is not sorted by the
+//    positions is sorted with a stable sort, which keeps the index order for equal positions.
+void sort_by_position(std::vector<double> &position, std::vector<int> &sorted_nodes, std::vector<uint32_t> &keys,
+                      std::vector<uint32_t> &key_buffer, std::vector<int> &node_buffer) {
+    int n = position.size();
+    double max_position = n == 0 ? 0 : *std::max_element(position.begin(), position.end());
+    int integer_bits = 0;
+    while (integer_bits < 32 && (uint64_t)max_position >> integer_bits != 0) {
+        integer_bits++;
+    }
+    // the digits have at most 11 bits, the fractional bits fill up the last digit
+    int num_digits = std::max(1, (integer_bits + 10) / 11);
+    int fraction_bits = std::min(num_digits * 11, 32) - integer_bits;
+    int digit_bits = (integer_bits + fraction_bits + num_digits - 1) / num_digits;
+    int num_buckets = 1 << digit_bits;
+
+    sorted_nodes.resize(n);
+    keys.resize(n);
+    key_buffer.resize(n);
+    node_buffer.resize(n);
+    double scale = (double)((uint64_t)1 << fraction_bits);
+    for (int v = 0; v < n; v++) {
+        keys[v] = position[v] * scale;
+        sorted_nodes[v] = v;
     }
-    return force_algorithm(initial_pos_to_idx, hyper_edges);
-}
 
-std::vector<int> force_clause_order(std::vector<int> &initial_pos_to_idx,
-                                      std::vector<planning_logic::logic_primitive> &primitives, int num_variables){
-                            
-    std::vector<std::vector<int>> hyper_edges(num_variables);
-    for(int p = 0; p < primitives.size(); p++) {
-        std::vector<int> affected_vars = primitives[p].get_affected_variables();
-        for(int v = 0; v < affected_vars.size(); v++){
-            int affected_var = affected_vars[v];
-            hyper_edges[affected_var].push_back(p);
+    std::vector<int> count(num_buckets);
+    for (int d = 0; d < num_digits; d++) {
+        int shift = d * digit_bits;
+        std::fill(count.begin(), count.end(), 0);
+        for (int i = 0; i < n; i++) {
+            count[(keys[i] >> shift) & (num_buckets - 1)]++;
         }
+        int start = 0;
+        for (int b = 0; b < num_buckets; b++) {
+            int size = count[b];
+            count[b] = start;
+            start += size;
+        }
+        for (int i = 0; i < n; i++) {
+            int pos = count[(keys[i] >> shift) & (num_buckets - 1)]++;
+            key_buffer[pos] = keys[i];
+            node_buffer[pos] = sorted_nodes[i];
+        }
+        keys.swap(key_buffer);
+        sorted_nodes.swap(node_buffer);
     }
 
-    return force_algorithm(initial_pos_to_idx, hyper_edges);
+    // within a run the nodes are ordered by their index, so a stable sort keeps the tiebreak
+    auto by_position = [&](int a, int b) { return position[a] < position[b]; };
+    for (int begin = 0; begin < n;) {
+        int end = begin + 1;
+        while (end < n && keys[end] == keys[begin]) {
+            end++;
+        }
+        if (end - begin > 1 && !std::is_sorted(sorted_nodes.begin() + begin, sorted_nodes.begin() + end, by_position)) {
+            std::stable_sort(sorted_nodes.begin() + begin, sorted_nodes.begin() + end, by_position);
+        }
+        begin = end;
+    }
 }
 
-// calculates the total span of all hyper edges
-// the span of a hyper edges is the difference between its lowest and highest node
-int calculate_total_span(std::vector<int> &node_to_pos, std::vector<std::vector<int>> &hyper_edges) {
-    int sum = 0;
-    for (int h = 0; h < hyper_edges.size(); h++) {
-        if(hyper_edges[h].size() == 0){
-            continue;
-        }
+namespace {
 
-        // calculate the span of the hyper edge
-        int left_pos = node_to_pos.size();
-        int right_pos = -1;
-        for (int v = 0; v < hyper_edges[h].size(); v++) {
-            int node = hyper_edges[h][v];
-            int pos = node_to_pos[node];
+// one pass over all hyper edges, that returns the total span and the truncated center of gravity of every edge
+int64_t span_and_center_of_gravity(std::vector<int> &node_to_pos, hypergraph &graph,
+                                   std::vector<int> &center_of_gravity) {
+    const int *offsets = graph.m_offsets.data();
+    const int *nodes = graph.m_nodes.data();
+    const int *positions = node_to_pos.data();
+    int num_edges = graph.num_edges();
 
+    int64_t total_span = 0;
+    for (int h = 0; h < num_edges; h++) {
+        int begin = offsets[h];
+        int end = offsets[h + 1];
+        if (begin == end) {
+            continue;
+        }
+        int left_pos = positions[nodes[begin]];
+        int right_pos = left_pos;
+        int64_t pos_sum = 0;
+        for (int i = begin; i < end; i++) {
+            int pos = positions[nodes[i]];
             left_pos = pos < left_pos ? pos : left_pos;
             right_pos = pos > right_pos ? pos : right_pos;
+            pos_sum += pos;
         }
+        total_span += right_pos - left_pos;
+        center_of_gravity[h] = pos_sum / (end - begin);
+    }
+    return total_span;
+}
+}  // namespace
+
+force_parameters::force_parameters(option_values &options)
+    : m_num_starts(options.force_num_starts),
+      m_num_threads(options.num_threads),
+      m_seed(options.force_seed),
+      m_shuffle_all(options.force_random_seed) {
+    if (options.force_seed < 0) {
+        m_seed = std::random_device{}();
+    }
+    if (m_num_starts > 1 || m_shuffle_all) {
+        LOG_MESSAGE(log_level::info) << "Force uses " << m_num_starts << " starts with seed " << m_seed;
+    }
+}
 
-        sum += (right_pos - left_pos);
+std::vector<int> force_variable_order(std::vector<int> &initial_pos_to_idx, planning_logic::primitive_store &store,
+                                      std::vector<int> &primitive_ids, force_parameters &parameters) {
+    hypergraph graph;
+    graph.m_offsets.reserve(primitive_ids.size() + 1);
+    graph.m_offsets.push_back(0);
+    for (int id : primitive_ids) {
+        graph.m_nodes.insert(graph.m_nodes.end(), store.support_begin(id), store.support_end(id));
+        graph.m_offsets.push_back(graph.m_nodes.size());
+    }
+    return multi_start_force_algorithm(initial_pos_to_idx, graph, parameters);
+}
+
+std::vector<int> force_clause_order(std::vector<int> &initial_pos_to_idx, planning_logic::primitive_store &store,
+                                    std::vector<int> &primitive_ids, int num_variables, force_parameters &parameters) {
+    // every variable is a hyper edge containing the primitives it occurs in
+    hypergraph graph;
+    graph.m_offsets.assign(num_variables + 1, 0);
+    for (int id : primitive_ids) {
+        for (const int *v = store.support_begin(id); v != store.support_end(id); v++) {
+            graph.m_offsets[*v + 1]++;
+        }
+    }
+    for (int v = 0; v < num_variables; v++) {
+        graph.m_offsets[v + 1] += graph.m_offsets[v];
     }
-    return sum;
+    graph.m_nodes.resize(graph.m_offsets[num_variables]);
+    std::vector<int> next(graph.m_offsets.begin(), graph.m_offsets.end() - 1);
+    for (int p = 0; p < primitive_ids.size(); p++) {
+        for (const int *v = store.support_begin(primitive_ids[p]); v != store.support_end(primitive_ids[p]); v++) {
+            graph.m_nodes[next[*v]++] = p;
+        }
+    }
+
+    return multi_start_force_algorithm(initial_pos_to_idx, graph, parameters);
 }
 
-std::vector<int> force_algorithm(std::vector<int> &position_to_node, std::vector<std::vector<int>> &hyper_edges) {
+int64_t calculate_total_span(std::vector<int> &node_to_pos, hypergraph &graph) {
+    std::vector<int> center_of_gravity(graph.num_edges());
+    return span_and_center_of_gravity(node_to_pos, graph, center_of_gravity);
+}
+
+std::vector<int> force_algorithm(std::vector<int> &position_to_node, hypergraph &graph,
+                                 force_statistics &statistics) {
     int num_vertices = position_to_node.size();
-    int num_hyperedges = hyper_edges.size();
+    int num_hyperedges = graph.num_edges();
 
     const int ITERATION_MULTIPLYER = 3;
     int max_iterations = ITERATION_MULTIPLYER * std::log2(num_vertices);
@@ -73,61 +178,92 @@ std::vector<int> force_algorithm(std::vector<int> &position_to_node, std::vector
         curr_node_to_position[curr_position_to_node[pos]] = pos;
     }
 
+    // the number of edges of a node does not change between the iterations
+    std::vector<int> num_edges(num_vertices, 0);
+    for (int node : graph.m_nodes) {
+        num_edges[node]++;
+    }
+
+    std::vector<int> center_of_gravity(num_hyperedges);
+    std::vector<int64_t> pos_sum(num_vertices);
+    std::vector<double> new_position(num_vertices);
+    std::vector<int> sorted_nodes(num_vertices), node_buffer;
+    std::vector<uint32_t> keys, key_buffer;
+
+    // the span of an order is calculated together with the centers of gravity for the next iteration
     int iteration = 0;
-    int initial_span = calculate_total_span(curr_node_to_position, hyper_edges);
-    int current_span = initial_span;
-    int last_span = current_span + 1;
+    int64_t initial_span = span_and_center_of_gravity(curr_node_to_position, graph, center_of_gravity);
+    int64_t current_span = initial_span;
+    int64_t last_span = current_span + 1;
     while (iteration < max_iterations && last_span - current_span > 0) {
-        // calculate center of gravity for every hyper edge
-        std::vector<double> center_of_gravity(num_hyperedges);
-        for (int h = 0; h < num_hyperedges; h++) {
-            double pos_sum = 0;
-            for (int v = 0; v < hyper_edges[h].size(); v++) {
-                pos_sum += curr_node_to_position[hyper_edges[h][v]];
-            }
-            center_of_gravity[h] = pos_sum / hyper_edges[h].size();
-        }
-
         // calculate new positioning for nodes
-        std::vector<double> pos_sum(num_vertices);
-        std::vector<int> num_edges(num_vertices);
+        std::fill(pos_sum.begin(), pos_sum.end(), 0);
         for (int h = 0; h < num_hyperedges; h++) {
-            for (int v = 0; v < hyper_edges[h].size(); v++) {
-                int node = hyper_edges[h][v];
-                int cog = center_of_gravity[h];
-
-                pos_sum[node] += cog;
-                num_edges[node] += 1;
+            int cog = center_of_gravity[h];
+            for (int i = graph.m_offsets[h]; i < graph.m_offsets[h + 1]; i++) {
+                pos_sum[graph.m_nodes[i]] += cog;
             }
         }
 
-        // sort nodes according to new position
-        std::vector<std::pair<double, int>> pos_node_pairs;
+        // sort nodes according to new position, ties are broken by the node index
         for (int v = 0; v < num_vertices; v++) {
-            if (num_edges[v] != 0){
-                pos_node_pairs.push_back(std::make_pair(pos_sum[v] / num_edges[v], v));
-            } else {
-                pos_node_pairs.push_back(std::make_pair(0.0f, v));
-            }
+            new_position[v] = num_edges[v] != 0 ? (double)pos_sum[v] / num_edges[v] : 0.0;
         }
-        
-        std::sort(pos_node_pairs.begin(), pos_node_pairs.end());
+        sort_by_position(new_position, sorted_nodes, keys, key_buffer, node_buffer);
 
         // calculate the node to position mappings again
         for (int v = 0; v < num_vertices; v++) {
-            curr_position_to_node[v] = pos_node_pairs[v].second;
+            curr_position_to_node[v] = sorted_nodes[v];
             curr_node_to_position[curr_position_to_node[v]] = v;
         }
 
         // update counters
         iteration++;
         last_span = current_span;
-        current_span = calculate_total_span(curr_node_to_position, hyper_edges);
+        current_span = span_and_center_of_gravity(curr_node_to_position, graph, center_of_gravity);
     }
 
-    LOG_MESSAGE(log_level::info) << "Force did " << iteration << " iterations, went from " << initial_span/num_hyperedges << " to " << current_span/num_hyperedges;
-
+    statistics.m_iterations = iteration;
+    statistics.m_initial_span = initial_span;
+    statistics.m_final_span = current_span;
     return curr_position_to_node;
 }
 
-};  // namespace variable_order
\ No newline at end of file
+std::vector<int> multi_start_force_algorithm(std::vector<int> &position_to_node, hypergraph &graph,
+                                             force_parameters &parameters) {
+    int num_starts = parameters.m_num_starts;
+    std::vector<std::vector<int>> orders(num_starts);
+    std::vector<force_statistics> statistics(num_starts);
+
+    thread_pool pool(std::min(parameters.m_num_threads, num_starts));
+    pool.parallel_for(num_starts, [&](int start) {
+        std::vector<int> initial_order = position_to_node;
+        if (start > 0 || parameters.m_shuffle_all) {
+            std::mt19937 rng(parameters.m_seed + start);
+            std::shuffle(initial_order.begin(), initial_order.end(), rng);
+        }
+        orders[start] = force_algorithm(initial_order, graph, statistics[start]);
+    });
+
+    // logging is only done from this thread
+    int num_hyperedges = graph.num_edges();
+    std::vector<int64_t> spans;
+    for (force_statistics &start_statistics : statistics) {
+        LOG_MESSAGE(log_level::info) << "Force did " << start_statistics.m_iterations << " iterations, went from "
+                                     << start_statistics.m_initial_span / num_hyperedges << " to "
+                                     << start_statistics.m_final_span / num_hyperedges;
+        spans.push_back(start_statistics.m_final_span);
+    }
+
+    int best = std::min_element(spans.begin(), spans.end()) - spans.begin();
+    if (num_starts > 1) {
+        std::vector<int64_t> sorted_spans = spans;
+        std::sort(sorted_spans.begin(), sorted_spans.end());
+        LOG_MESSAGE(log_level::info) << "Total spans of the " << num_starts << " force starts: min "
+                                     << sorted_spans.front() << ", median " << sorted_spans[num_starts / 2]
+                                     << ", max " << sorted_spans.back() << ". Using start " << best;
+    }
+    return orders[best];
+}
+
+};  // namespace variable_order
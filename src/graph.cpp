@@ -1,7 +1,9 @@
 #include "graph.h"
 
 #include "logging.h"
+#include "thread_pool.h"
 
+#include <algorithm>
 #include <unordered_set>
 #include <queue>
 #include <iostream>
@@ -9,37 +11,179 @@
 
 namespace graph {
 
-undirected_graph::undirected_graph(int num_nodes) { m_edge_list = std::vector<std::vector<int>>(num_nodes); }
+undirected_graph::undirected_graph(int num_nodes)
+    : m_num_nodes(num_nodes), m_is_dense(num_nodes <= dense_node_limit), m_num_words((num_nodes + 63) / 64) {
+    if (m_is_dense) {
+        m_bits = std::vector<uint64_t>((size_t)num_nodes * m_num_words, 0);
+    }
+    m_offsets = std::vector<int>(num_nodes + 1, 0);
+}
 
 void undirected_graph::add_edge(int nodeA, int nodeB) {
-    m_edge_list[nodeA].push_back(nodeB);
-    m_edge_list[nodeB].push_back(nodeA);
+    if (m_is_dense) {
+        uint64_t &bit_word = m_bits[(size_t)nodeA * m_num_words + nodeB / 64];
+        if (bit_word & ((uint64_t)1 << (nodeB % 64))) {
+            return;
+        }
+        bit_word |= (uint64_t)1 << (nodeB % 64);
+        m_bits[(size_t)nodeB * m_num_words + nodeA / 64] |= (uint64_t)1 << (nodeA % 64);
+    } else {
+        m_new_edges.push_back(std::make_pair(nodeA, nodeB));
+    }
+    m_is_compressed = false;
 }
 
-int undirected_graph::get_num_nodes() { return m_edge_list.size(); }
+void undirected_graph::set_all_neighbours(thread_pool &pool,
+                                          const std::function<void(int, std::vector<int> &)> &find_neighbours) {
+    std::vector<std::vector<int>> rows(m_num_nodes);
+    pool.parallel_for(m_num_nodes, [&](int node) { find_neighbours(node, rows[node]); });
 
-bool undirected_graph::are_neighbours(int nodeA, int nodeB) {
-    for (int x : get_neighbours(nodeA)) {
-        if (x == nodeB) {
-            return true;
+    for (int node = 0; node < m_num_nodes; node++) {
+        m_offsets[node + 1] = m_offsets[node] + rows[node].size();
+    }
+    m_targets.resize(m_offsets[m_num_nodes]);
+    // every node only writes its own row of the neighbour lists and of the bitset
+    pool.parallel_for(m_num_nodes, [&](int node) {
+        std::copy(rows[node].begin(), rows[node].end(), m_targets.begin() + m_offsets[node]);
+        if (m_is_dense) {
+            uint64_t *bits = m_bits.data() + (size_t)node * m_num_words;
+            std::fill(bits, bits + m_num_words, 0);
+            for (int neighbour : rows[node]) {
+                bits[neighbour / 64] |= (uint64_t)1 << (neighbour % 64);
+            }
         }
+        std::vector<int>().swap(rows[node]);
+    });
+    m_new_edges.clear();
+    m_is_compressed = true;
+}
+
+void undirected_graph::compress() {
+    if (m_is_compressed) {
+        return;
     }
-    return false;
+    m_is_compressed = true;
+    if (m_is_dense) {
+        // the set bits of every row are already sorted and unique
+        m_targets.clear();
+        for (int node = 0; node < m_num_nodes; node++) {
+            m_offsets[node] = m_targets.size();
+            for (int w = 0; w < m_num_words; w++) {
+                uint64_t word = m_bits[(size_t)node * m_num_words + w];
+                while (word) {
+                    m_targets.push_back(w * 64 + __builtin_ctzll(word));
+                    word &= word - 1;
+                }
+            }
+        }
+        m_offsets[m_num_nodes] = m_targets.size();
+        return;
+    }
+    // old and new neighbours of every node, each list is sorted and made unique afterwards
+    std::vector<int> offsets(m_num_nodes + 1, 0);
+    for (int node = 0; node < m_num_nodes; node++) {
+        offsets[node + 1] = m_offsets[node + 1] - m_offsets[node];
+    }
+    for (std::pair<int, int> &edge : m_new_edges) {
+        offsets[edge.first + 1]++;
+        offsets[edge.second + 1]++;
+    }
+    for (int node = 0; node < m_num_nodes; node++) {
+        offsets[node + 1] += offsets[node];
+    }
+    std::vector<int> targets(offsets[m_num_nodes]);
+    std::vector<int> position(offsets.begin(), offsets.end() - 1);
+    for (int node = 0; node < m_num_nodes; node++) {
+        for (int i = m_offsets[node]; i < m_offsets[node + 1]; i++) {
+            targets[position[node]++] = m_targets[i];
+        }
+    }
+    for (std::pair<int, int> &edge : m_new_edges) {
+        targets[position[edge.first]++] = edge.second;
+        targets[position[edge.second]++] = edge.first;
+    }
+
+    int num_targets = 0;
+    for (int node = 0; node < m_num_nodes; node++) {
+        std::sort(targets.begin() + offsets[node], targets.begin() + offsets[node + 1]);
+        int first = num_targets;
+        for (int i = offsets[node]; i < offsets[node + 1]; i++) {
+            if (num_targets == first || targets[num_targets - 1] != targets[i]) {
+                targets[num_targets++] = targets[i];
+            }
+        }
+        m_offsets[node] = first;
+    }
+    m_offsets[m_num_nodes] = num_targets;
+    targets.resize(num_targets);
+    m_targets = std::move(targets);
+    m_new_edges.clear();
 }
 
-std::vector<int> undirected_graph::get_neighbours(int node) { return m_edge_list[node]; }
+int undirected_graph::get_num_nodes() { return m_num_nodes; }
 
-undirected_graph undirected_graph::construct_complement() {
-    int num_nodes = get_num_nodes();
-    undirected_graph result(get_num_nodes());
+int undirected_graph::get_num_edges() {
+    compress();
+    return m_targets.size() / 2;
+}
+
+bool undirected_graph::are_neighbours(int nodeA, int nodeB) {
+    if (m_is_dense) {
+        return m_bits[(size_t)nodeA * m_num_words + nodeB / 64] & ((uint64_t)1 << (nodeB % 64));
+    }
+    neighbour_range range = neighbours(nodeA);
+    return std::binary_search(range.begin(), range.end(), nodeB);
+}
+
+std::vector<int> undirected_graph::get_neighbours(int node) {
+    neighbour_range range = neighbours(node);
+    return std::vector<int>(range.begin(), range.end());
+}
 
-    for (int i = 0; i < num_nodes; i++) {
-        for (int j = i + 1; j < num_nodes; j++) {
-            if (!are_neighbours(i, j)) {
-                result.add_edge(i, j);
+neighbour_range undirected_graph::neighbours(int node) {
+    compress();
+    const int *targets = m_targets.data();
+    return neighbour_range(targets + m_offsets[node], targets + m_offsets[node + 1]);
+}
+
+undirected_graph undirected_graph::construct_complement() {
+    compress();
+    undirected_graph result(m_num_nodes);
+    std::vector<int> &offsets = result.m_offsets;
+    std::vector<int> &targets = result.m_targets;
+
+    for (int node = 0; node < m_num_nodes; node++) {
+        offsets[node] = targets.size();
+        if (m_is_dense) {
+            // complement whole words and collect their set bits
+            for (int w = 0; w < m_num_words; w++) {
+                uint64_t word = ~m_bits[(size_t)node * m_num_words + w];
+                if (w == m_num_words - 1 && m_num_nodes % 64 != 0) {
+                    word &= ((uint64_t)1 << (m_num_nodes % 64)) - 1;
+                }
+                if (w == node / 64) {
+                    word &= ~((uint64_t)1 << (node % 64));
+                }
+                result.m_bits[(size_t)node * m_num_words + w] = word;
+                while (word) {
+                    targets.push_back(w * 64 + __builtin_ctzll(word));
+                    word &= word - 1;
+                }
+            }
+        } else {
+            // every node that is not in the sorted neighbour list
+            const int *neighbour = m_targets.data() + m_offsets[node];
+            const int *end = m_targets.data() + m_offsets[node + 1];
+            for (int other = 0; other < m_num_nodes; other++) {
+                if (neighbour != end && *neighbour == other) {
+                    neighbour++;
+                } else if (other != node) {
+                    targets.push_back(other);
+                }
             }
         }
     }
+    offsets[m_num_nodes] = targets.size();
 
     return result;
 }
@@ -53,12 +197,8 @@ void write_to_file(std::string filepath, undirected_graph &graph) {
     dot_file << "\toverlap=scale;\n";
     dot_file << "\tsplines=true;\n";
 
-    auto edges = graph.m_edge_list;
-
-    for (int i = 0; i < edges.size(); i++) {
-        for (int j = 0; j < edges[i].size(); j++) {
-            int neighbour = edges[i][j];
-
+    for (int i = 0; i < graph.get_num_nodes(); i++) {
+        for (int neighbour : graph.neighbours(i)) {
             if (neighbour > i) {
                 dot_file << "\t" << i << " -- " << neighbour << ";\n";
             }
@@ -107,11 +247,8 @@ void write_to_file_with_colouring(std::string filepath, undirected_graph &graph,
         }
     }
 
-    auto edges = graph.m_edge_list;
-    for (int i = 0; i < edges.size(); i++) {
-        for (int j = 0; j < edges[i].size(); j++) {
-            int neighbour = edges[i][j];
-
+    for (int i = 0; i < graph.get_num_nodes(); i++) {
+        for (int neighbour : graph.neighbours(i)) {
             if (neighbour > i) {
                 dot_file << "\t" << i << " -- " << neighbour << ";\n";
             }
@@ -134,7 +271,8 @@ std::vector<int> approximate_colouring(undirected_graph &graph) {
 
     // initialize data structures
     for (int i = 0; i < n; i++) {
-        int deg_i = graph.get_neighbours(i).size();
+        int deg_i = graph.neighbours(i).size();
+        num_uncoloured[i] = deg_i;
         queue.push(std::make_tuple(0, deg_i, i));
     }
 
@@ -144,7 +282,7 @@ std::vector<int> approximate_colouring(undirected_graph &graph) {
         queue.pop();
         int node_id, deg_i;
         node_id = std::get<2>(curr_best);
-        std::vector<int> neighbours = graph.get_neighbours(node_id);
+        neighbour_range neighbours = graph.neighbours(node_id);
         deg_i = neighbours.size();
 
         // node is already coloured
@@ -152,12 +290,12 @@ std::vector<int> approximate_colouring(undirected_graph &graph) {
             continue;
         }
 
-        // find minimum unused colour
-        int min_colour;
+        // find minimum unused colour, one of the deg_i + 1 smallest colours is always free
+        int min_colour = deg_i;
         std::vector<bool> used(deg_i + 1, false);
         for (int i = 0; i < deg_i; i++) {
             int neigh_col = colouring[neighbours[i]];
-            if (neigh_col != -1) {
+            if (neigh_col != -1 && neigh_col <= deg_i) {
                 used[neigh_col] = true;
             }
         }
@@ -173,7 +311,7 @@ std::vector<int> approximate_colouring(undirected_graph &graph) {
 
         // update neighbours
         for (int i = 0; i < deg_i; i++) {
-            if (colouring[i] != -1) {
+            if (colouring[neighbours[i]] != -1) {
                 continue;
             }
 
@@ -0,0 +1,364 @@
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+#include "graph.h"
+#include "logging.h"
+
+namespace graph {
+
+namespace {
+
+// the tabu search keeps a conflict counter and a tabu tenure for every pair of node and colour
+// both tables together may use at most this many bytes
+const long tabu_search_max_table_bytes = 256L << 20;
+
+class colouring_clock {
+   public:
+    colouring_clock(double time_budget) : m_start(std::chrono::steady_clock::now()), m_time_budget(time_budget) {}
+
+    double elapsed() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+    }
+    bool is_over() { return elapsed() >= m_time_budget; }
+
+   private:
+    std::chrono::steady_clock::time_point m_start;
+    double m_time_budget;
+};
+
+// colours the nodes in the given order with the smallest colour that is not used by a neighbour
+std::vector<int> greedy_colouring(undirected_graph &graph, const std::vector<int> &order) {
+    int n = graph.get_num_nodes();
+    std::vector<int> colouring(n, -1);
+    // forbidden[c] == node marks the colours of the neighbours of node
+    std::vector<int> forbidden(n + 1, -1);
+    for (int node : order) {
+        for (int neighbour : graph.neighbours(node)) {
+            if (colouring[neighbour] != -1) {
+                forbidden[colouring[neighbour]] = node;
+            }
+        }
+        int colour = 0;
+        while (forbidden[colour] == node) {
+            colour++;
+        }
+        colouring[node] = colour;
+    }
+    return colouring;
+}
+
+// one step of the iterated greedy algorithm: colouring the nodes class by class never needs more colours
+std::vector<int> iterated_greedy_step(undirected_graph &graph, const std::vector<int> &colouring, std::mt19937 &random) {
+    int k = num_colours(colouring);
+    std::vector<std::vector<int>> classes(k);
+    for (int node = 0; node < colouring.size(); node++) {
+        classes[colouring[node]].push_back(node);
+    }
+    switch (random() % 3) {
+        case 0:
+            std::reverse(classes.begin(), classes.end());
+            break;
+        case 1:
+            std::stable_sort(classes.begin(), classes.end(),
+                             [](const std::vector<int> &a, const std::vector<int> &b) { return a.size() > b.size(); });
+            break;
+        default:
+            std::shuffle(classes.begin(), classes.end(), random);
+            break;
+    }
+    std::vector<int> order;
+    for (std::vector<int> &colour_class : classes) {
+        order.insert(order.end(), colour_class.begin(), colour_class.end());
+    }
+    return greedy_colouring(graph, order);
+}
+
+// tabu search for a colouring with k colours, starting from a colouring with k + 1 colours
+// the smallest colour class is removed and its nodes are moved to the colour with the fewest conflicts.
+// Returns an empty vector if no colouring without conflicts was found in time
+std::vector<int> tabu_search(undirected_graph &graph, const std::vector<int> &start, int k, colouring_clock &clock,
+                             std::mt19937 &random) {
+    int n = graph.get_num_nodes();
+    std::vector<int> class_size(k + 1, 0);
+    for (int colour : start) {
+        class_size[colour]++;
+    }
+    int removed = std::min_element(class_size.begin(), class_size.end()) - class_size.begin();
+
+    std::vector<int> colouring(start);
+    std::vector<int> conflicts((size_t)n * k, 0);
+    auto conflict = [&](int node, int colour) -> int & { return conflicts[(size_t)node * k + colour]; };
+    for (int node = 0; node < n; node++) {
+        if (colouring[node] == removed) {
+            colouring[node] = -1;
+        } else if (colouring[node] == k) {
+            colouring[node] = removed;
+        }
+    }
+    for (int node = 0; node < n; node++) {
+        if (colouring[node] != -1) {
+            for (int neighbour : graph.neighbours(node)) {
+                conflict(neighbour, colouring[node])++;
+            }
+        }
+    }
+    for (int node = 0; node < n; node++) {
+        if (colouring[node] != -1) {
+            continue;
+        }
+        int best = 0;
+        for (int colour = 1; colour < k; colour++) {
+            best = conflict(node, colour) < conflict(node, best) ? colour : best;
+        }
+        colouring[node] = best;
+        for (int neighbour : graph.neighbours(node)) {
+            conflict(neighbour, best)++;
+        }
+    }
+
+    // nodes that have a neighbour with the same colour
+    std::vector<int> conflicting;
+    std::vector<int> position(n, -1);
+    auto update_conflicting = [&](int node) {
+        bool is_conflicting = conflict(node, colouring[node]) > 0;
+        if (is_conflicting && position[node] == -1) {
+            position[node] = conflicting.size();
+            conflicting.push_back(node);
+        } else if (!is_conflicting && position[node] != -1) {
+            int last = conflicting.back();
+            conflicting[position[node]] = last;
+            position[last] = position[node];
+            conflicting.pop_back();
+            position[node] = -1;
+        }
+    };
+    long num_conflicts = 0;
+    for (int node = 0; node < n; node++) {
+        num_conflicts += conflict(node, colouring[node]);
+        update_conflicting(node);
+    }
+    num_conflicts /= 2;
+
+    // a move of a node back to a colour is tabu until the given iteration
+    std::vector<long> tabu_until((size_t)n * k, 0);
+    long best_conflicts = num_conflicts;
+    for (long iteration = 0; num_conflicts > 0; iteration++) {
+        if (iteration % 100 == 0 && clock.is_over()) {
+            return std::vector<int>();
+        }
+        int best_node = -1, best_colour = -1, best_delta = 0, num_best = 0;
+        for (int node : conflicting) {
+            int current = conflict(node, colouring[node]);
+            for (int colour = 0; colour < k; colour++) {
+                if (colour == colouring[node]) {
+                    continue;
+                }
+                int delta = conflict(node, colour) - current;
+                bool is_tabu = tabu_until[(size_t)node * k + colour] > iteration;
+                // aspiration: tabu moves are allowed if they lead to the best state so far
+                if (is_tabu && num_conflicts + delta >= best_conflicts) {
+                    continue;
+                }
+                if (best_node == -1 || delta < best_delta) {
+                    best_node = node;
+                    best_colour = colour;
+                    best_delta = delta;
+                    num_best = 1;
+                } else if (delta == best_delta && random() % ++num_best == 0) {
+                    best_node = node;
+                    best_colour = colour;
+                }
+            }
+        }
+        if (best_node == -1) {
+            // every move is tabu
+            continue;
+        }
+
+        int old_colour = colouring[best_node];
+        colouring[best_node] = best_colour;
+        for (int neighbour : graph.neighbours(best_node)) {
+            conflict(neighbour, old_colour)--;
+            conflict(neighbour, best_colour)++;
+            update_conflicting(neighbour);
+        }
+        update_conflicting(best_node);
+        num_conflicts += best_delta;
+        best_conflicts = std::min(best_conflicts, num_conflicts);
+        tabu_until[(size_t)best_node * k + old_colour] = iteration + (long)(0.6 * conflicting.size()) + random() % 10 + 1;
+    }
+    return colouring;
+}
+// size of a clique that is found greedily, a lower bound for the number of colours
+int greedy_clique_size(undirected_graph &graph) {
+    int n = graph.get_num_nodes();
+    if (n == 0) {
+        return 0;
+    }
+    int start = 0;
+    for (int node = 1; node < n; node++) {
+        start = graph.neighbours(node).size() > graph.neighbours(start).size() ? node : start;
+    }
+    std::vector<int> candidates = graph.get_neighbours(start);
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [&](int a, int b) { return graph.neighbours(a).size() > graph.neighbours(b).size(); });
+    std::vector<int> clique(1, start);
+    for (int candidate : candidates) {
+        bool is_connected = true;
+        for (int i = 0; i < clique.size() && is_connected; i++) {
+            is_connected = graph.are_neighbours(candidate, clique[i]);
+        }
+        if (is_connected) {
+            clique.push_back(candidate);
+        }
+    }
+    return clique.size();
+}
+}  // namespace
+
+int num_colours(const std::vector<int> &colouring) {
+    int max = -1;
+    for (int colour : colouring) {
+        max = colour > max ? colour : max;
+    }
+    return max + 1;
+}
+
+std::vector<int> dsatur_colouring(undirected_graph &graph) {
+    int n = graph.get_num_nodes();
+    std::vector<int> colouring(n, -1);
+    std::vector<int> saturation(n, 0);
+    // neighbour_colours[node][c] is true if a neighbour of node has colour c
+    std::vector<std::vector<bool>> neighbour_colours(n);
+
+    // the rank of a node is its position when sorted by decreasing degree
+    std::vector<int> node_of_rank(n);
+    for (int node = 0; node < n; node++) {
+        node_of_rank[node] = node;
+    }
+    std::stable_sort(node_of_rank.begin(), node_of_rank.end(),
+                     [&](int a, int b) { return graph.neighbours(a).size() > graph.neighbours(b).size(); });
+    std::vector<int> rank(n);
+    for (int r = 0; r < n; r++) {
+        rank[node_of_rank[r]] = r;
+    }
+
+    // bucket queue over the saturation. Every bucket is a bitset over the ranks, so the first set bit is the node
+    // with the highest degree. first_word[s] is a lower bound on the first non zero word of bucket s
+    int num_words = (n + 63) / 64;
+    std::vector<std::vector<uint64_t>> buckets;
+    std::vector<int> first_word;
+    auto insert = [&](int s, int r) {
+        if (buckets.size() <= s) {
+            buckets.resize(s + 1);
+            first_word.resize(s + 1, num_words);
+        }
+        if (buckets[s].empty()) {
+            buckets[s].resize(num_words, 0);
+        }
+        buckets[s][r / 64] |= (uint64_t)1 << (r % 64);
+        first_word[s] = std::min(first_word[s], r / 64);
+    };
+    auto erase = [&](int s, int r) { buckets[s][r / 64] &= ~((uint64_t)1 << (r % 64)); };
+    // returns the first rank in bucket s or -1 if it is empty
+    auto first = [&](int s) {
+        if (buckets[s].empty()) {
+            return -1;
+        }
+        while (first_word[s] < num_words && buckets[s][first_word[s]] == 0) {
+            first_word[s]++;
+        }
+        if (first_word[s] == num_words) {
+            return -1;
+        }
+        return first_word[s] * 64 + __builtin_ctzll(buckets[s][first_word[s]]);
+    };
+
+    for (int r = 0; r < n; r++) {
+        insert(0, r);
+    }
+    int max_saturation = 0;
+    for (int i = 0; i < n; i++) {
+        int r = first(max_saturation);
+        while (r == -1) {
+            max_saturation--;
+            r = first(max_saturation);
+        }
+        erase(max_saturation, r);
+        int node = node_of_rank[r];
+
+        int colour = 0;
+        while (colour < neighbour_colours[node].size() && neighbour_colours[node][colour]) {
+            colour++;
+        }
+        colouring[node] = colour;
+
+        // only neighbours that see the colour for the first time move to another bucket
+        for (int neighbour : graph.neighbours(node)) {
+            std::vector<bool> &colours = neighbour_colours[neighbour];
+            if (colouring[neighbour] != -1 || (colour < colours.size() && colours[colour])) {
+                continue;
+            }
+            if (colours.size() <= colour) {
+                colours.resize(colour + 1, false);
+            }
+            colours[colour] = true;
+            erase(saturation[neighbour], rank[neighbour]);
+            saturation[neighbour]++;
+            insert(saturation[neighbour], rank[neighbour]);
+            max_saturation = std::max(max_saturation, saturation[neighbour]);
+        }
+    }
+    return colouring;
+}
+
+std::vector<int> improved_colouring(undirected_graph &graph, double time_budget) {
+    colouring_clock clock(time_budget);
+    std::mt19937 random(0);
+
+    std::vector<int> best = dsatur_colouring(graph);
+    int best_k = num_colours(best);
+    LOG_MESSAGE(log_level::info) << "Colouring with " << best_k << " colours after " << clock.elapsed()
+                                 << "s (dsatur)";
+
+    if (time_budget <= 0) {
+        return best;
+    }
+    int lower_bound = greedy_clique_size(graph);
+    LOG_MESSAGE(log_level::info) << "The graph contains a clique of size " << lower_bound;
+
+    bool use_tabu_search = (long)graph.get_num_nodes() * best_k * (long)(sizeof(int) + sizeof(long)) <=
+                           tabu_search_max_table_bytes;
+    // the iterated greedy steps run until they did not improve the colouring for a while, then tabu search tries to
+    // remove a colour
+    const int max_steps_without_improvement = 50;
+    int steps_without_improvement = 0;
+    while (best_k > lower_bound && !clock.is_over()) {
+        if (steps_without_improvement < max_steps_without_improvement || !use_tabu_search) {
+            std::vector<int> next = iterated_greedy_step(graph, best, random);
+            int next_k = num_colours(next);
+            steps_without_improvement++;
+            if (next_k < best_k) {
+                LOG_MESSAGE(log_level::info) << "Colouring with " << next_k << " colours after " << clock.elapsed()
+                                             << "s (iterated greedy)";
+                steps_without_improvement = 0;
+                best_k = next_k;
+            }
+            best = next;
+            continue;
+        }
+
+        std::vector<int> next = tabu_search(graph, best, best_k - 1, clock, random);
+        if (next.empty()) {
+            break;
+        }
+        best = next;
+        best_k--;
+        steps_without_improvement = 0;
+        LOG_MESSAGE(log_level::info) << "Colouring with " << best_k << " colours after " << clock.elapsed()
+                                     << "s (tabu search)";
+    }
+    return best;
+}
+}  // namespace graph
@@ -1,36 +1,42 @@
 #include "logic_primitive.h"
 
-#include <set>
+#include <algorithm>
+#include <cstdlib>
 
 #include "logging.h"
 
 namespace planning_logic {
 
 std::vector<int> logic_primitive::get_affected_variables() const {
+    std::vector<int> affected_vars;
     switch (m_type) {
         case logic_clause:
-        case logic_eo: {
-            std::set<int> affected_vars;
-
+        case logic_eo:
+        case logic_amo: {
+            affected_vars.reserve(m_data.size());
             for (int i = 0; i < m_data.size(); i++) {
-                affected_vars.insert(std::abs(m_data[i]));
+                affected_vars.push_back(std::abs(m_data[i]));
             }
-            return std::vector<int>(affected_vars.begin(), affected_vars.end());
+            break;
         }
-        case logic_dnf: {
-            std::set<int> affected_vars;
-
+        case logic_dnf:
+        case logic_implication:
+        case logic_transition: {
             for (int i = 0; i < m_dnf_data.size(); i++) {
                 for (int j = 0; j < m_dnf_data[i].size(); j++) {
-                    affected_vars.insert(std::abs(m_dnf_data[i][j]));
+                    affected_vars.push_back(std::abs(m_dnf_data[i][j]));
                 }
             }
-            return std::vector<int>(affected_vars.begin(), affected_vars.end());
+            break;
         }
         default:
             LOG_MESSAGE(log_level::error) << "Unknown primitive type";
             return std::vector<int>();
     }
+    // sorted and without duplicates
+    std::sort(affected_vars.begin(), affected_vars.end());
+    affected_vars.erase(std::unique(affected_vars.begin(), affected_vars.end()), affected_vars.end());
+    return affected_vars;
 }
 
 std::string logic_primitive::to_string() {
@@ -45,6 +51,15 @@ std::string logic_primitive::to_string() {
         case logic_eo:
             type = "eo";
             break;
+        case logic_amo:
+            type = "amo";
+            break;
+        case logic_implication:
+            type = "imp";
+            break;
+        case logic_transition:
+            type = "tr";
+            break;
         default:
             LOG_MESSAGE(log_level::error) << "Unknown primitive type";
             type = "none";
@@ -55,8 +70,11 @@ std::string logic_primitive::to_string() {
     for (int x : m_data) {
         data += std::to_string(x) + " ";
     }
-    for (std::vector<int> con : m_dnf_data) {
-        for (int x : con) {
+    for (int i = 0; i < m_dnf_data.size(); i++) {
+        if (i > 0 && std::find(m_dnf_offsets.begin(), m_dnf_offsets.end(), i) != m_dnf_offsets.end()) {
+            data += "| ";
+        }
+        for (int x : m_dnf_data[i]) {
             data += std::to_string(x) + " ";
         }
         data += ",";
@@ -69,7 +87,10 @@ bool logic_primitive::operator<(const logic_primitive& rhs) const {
         if (m_data.size() != 0) {
             return m_data < rhs.m_data;
         } else {
-            return m_dnf_data < rhs.m_dnf_data;
+            if (m_dnf_data != rhs.m_dnf_data) {
+                return m_dnf_data < rhs.m_dnf_data;
+            }
+            return m_dnf_offsets < rhs.m_dnf_offsets;
         }
     } else {
         return m_type < rhs.m_type;
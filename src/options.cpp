@@ -1,5 +1,7 @@
 #include "options.h"
 
+#include "code_assignment.h"
+
 namespace po = boost::program_options;
 
 void option_parser::parse_command_line(int argc, char *argv[]) {
@@ -32,6 +34,18 @@ void option_parser::parse_command_line(int argc, char *argv[]) {
          "builds the bdd in a naiv way and makes no optimizations. used as a baseline")  //
         ("build_sdd_naiv", po::bool_switch(&m_values.build_sdd_naiv)->default_value(false),
          "Uses the default sdd compiler to build an sdd")  //
+        ("benchmark_parser", po::bool_switch(&m_values.benchmark_parser)->default_value(false),
+         "Compares the runtime of the memory mapped sas tokenizer with the old line based parser")  //
+        ("benchmark_conflict_graph", po::bool_switch(&m_values.benchmark_conflict_graph)->default_value(false),
+         "Compares the runtime of the bucket based action conflict graph construction with the pairwise one")  //
+        ("benchmark_force_sort", po::bool_switch(&m_values.benchmark_force_sort)->default_value(false),
+         "Checks that the radix sort of force orders random positions like std::sort and compares their runtime. "
+         "Uses force_seed")  //
+        ("benchmark_runs", po::value<int>(&m_values.benchmark_runs)->default_value(10),
+         "How often each benchmark is repeated")  //
+        ("num_threads", po::value<int>(&m_values.num_threads)->default_value(1),
+         "Number of threads used to generate the logic primitives of all timesteps and the action conflict graph. The "
+         "result does not depend on the number of threads")  //
         // DD building parameters
         ("timesteps", po::value<int>(&m_values.timesteps)->default_value(-1),
          "The amount of timsteps represented by the cnf formula")  //
@@ -39,6 +53,17 @@ void option_parser::parse_command_line(int argc, char *argv[]) {
          "The amount of plans the planner will search for")  //
         ("quality_bound", po::value<double>(&m_values.quality_bound)->default_value(-1.0),
          "Used as a relative quality bound for Top-Q planning")  //
+        ("simplify_task", po::bool_switch(&m_values.simplify_task)->default_value(false),
+         "Removes unreachable values and operators, constant and irrelevant variables and merges duplicate operators "
+         "before the problem is encoded. The number of plans is reported with the multiplicities of merged "
+         "operators. With parallel_plan, exists_step or binary_parallel only unreachable parts are removed")  //
+        ("h2_mutexes", po::bool_switch(&m_values.h2_mutexes)->default_value(false),
+         "Calculates the pairs of facts that can not hold at the same time with h2 and adds them to the mutex groups "
+         "of the sas problem. They are encoded with include_mutex")  //
+        ("reachability_pruning", po::bool_switch(&m_values.reachability_pruning)->default_value(false),
+         "Only creates the variables and primitives of facts and operators that are reachable from the initial state "
+         "and from which the goal can be reached in the remaining timesteps. Can not be used with "
+         "use_layer_permutation or layer_expo")  //
         // what and how to conjoin clauses?
         ("include_mutex", po::bool_switch(&m_values.include_mutex)->default_value(false),
          "If this flag is set, the cnf encoder will include the mutexes from the sas problem in its formula")  //
@@ -48,18 +73,48 @@ void option_parser::parse_command_line(int argc, char *argv[]) {
          "Uses DNF primitives to group the precondition and effect constraints into a singel DNF")  //
         ("exact_one_constraint", po::bool_switch(&m_values.exact_one_constraint)->default_value(false),
          "Builds the exactly one variable is true constraints directly into the DD")  //
+        ("amo_constraint", po::bool_switch(&m_values.amo_constraint)->default_value(false),
+         "Builds the at most one constraints (unary mutex groups and operator exclusivity) directly into the DD "
+         "instead of conjoining one clause per pair")  //
+        ("transition_frame", po::bool_switch(&m_values.transition_frame)->default_value(false),
+         "Combines the frame axioms of all values of a variable into one transition primitive, which is built on its "
+         "own before it is conjoined with the DD")  //
         ("parallel_plan", po::bool_switch(&m_values.parallel_plan)->default_value(false),
          "Only prohibits conflicting operators in one timestep. Does not work with exact one encoding or binary "
          "encoding.")  //
+        ("exists_step", po::bool_switch(&m_values.exists_step)->default_value(false),
+         "Allows multiple operators in one timestep, if they can be applied in the order of their indices. The "
+         "number of solutions counts step plans (steps may be empty), not sequential plans. Needs the unary "
+         "operator encoding and build_bdd")  //
+        ("commutation_reduction", po::bool_switch(&m_values.commutation_reduction)->default_value(false),
+         "Two commuting operators (neither changes a variable the other one reads or changes) may only follow each "
+         "other in the order of their indices. Every plan can be reordered into one of the remaining plans, so the "
+         "number of solutions is reduced, but still at least the number of plans that are different up to the order "
+         "of commuting operators. The DD is not necessarily smaller, for gripper it grows. Needs the sequential "
+         "unary operator encoding")  //
+        ("symmetry_breaking", po::bool_switch(&m_values.symmetry_breaking)->default_value(false),
+         "Searches objects that can be exchanged without changing the problem and only allows plans that touch them "
+         "for the first time in a fixed order. The number of plans including the symmetric plans is printed "
+         "separately. Needs the sequential unary operator encoding")  //
         ("binary_encoding", po::bool_switch(&m_values.binary_encoding)->default_value(false),
          "Encodes the actions in a binary and not a unary way. Resulting in only log(|action|) variables.")  //
         ("binary_variables", po::bool_switch(&m_values.binary_variables)->default_value(false),
          "Encodes the mutiple values of a planning variable in a binary and not a unary way. Resulting in only "
          "log(|value|) variables.")  //
+        ("adaptive_encoding", po::bool_switch(&m_values.adaptive_encoding)->default_value(false),
+         "Chooses the unary or binary encoding for every variable with a cost model of the domain size and the "
+         "number of preconditions and effects of the variable. Overrides binary_variables")  //
         ("binary_exclude_impossible", po::bool_switch(&m_values.binary_exclude_impossible)->default_value(false),
          "Excludes the impossible (dummy) actions from the logic formula, if binary encoding is used.")  //
+        ("binary_code_assignment", po::value<std::string>(&m_values.binary_code_assignment)->default_value("plain"),
+         "Assignment of the codes of binary encoded operators and values. plain: index order, gray: gray codes in "
+         "index order, cluster: gray codes in an order where operators with similar effects and values connected in "
+         "the domain transition graph follow each other")  //
         ("binary_parallel", po::bool_switch(&m_values.binary_parallel)->default_value(false),
          "Combination of binary and parallel plan encoding. Should be used wit timestep -1.")  //
+        ("colouring_time_budget", po::value<double>(&m_values.colouring_time_budget)->default_value(0.0),
+         "Seconds used to reduce the number of colour classes of binary_parallel (and conflict_graph) with iterated "
+         "greedy and tabu search after the DSATUR colouring. Every colour class needs its own operator variables")  //
         ("build_order", po::value<std::string>(&m_values.build_order)->default_value("igx:rympec:"),
          "Determins the order of conjoins when building a dd linearily and not interleaved. Must be a permutation of "
          "the string impgc; i: initial_state, rtyum: mutex, pe: precondition/effect, g: goal, c: changing atoms "
@@ -67,6 +122,12 @@ void option_parser::parse_command_line(int argc, char *argv[]) {
         ("reverse_order", po::bool_switch(&m_values.reverse_order)->default_value(false),
          "Reverses the order of the conjoin operations. This has the effect that the conjoin order gets reversed but "
          "also clauses with higher timesteps get conjoined first.")  //
+        ("preprocess", po::bool_switch(&m_values.preprocess)->default_value(false),
+         "Simplifies the ordered primitives before they are conjoined: unit propagation, removal of duplicate and "
+         "subsumed clauses. Does not change the number of solutions")  //
+        ("stream_primitives", po::bool_switch(&m_values.stream_primitives)->default_value(false),
+         "Conjoins the primitives of every (tag, timestep) pair of the custom build order while they are encoded, "
+         "instead of collecting all primitives first. Needs linear and clause_order_custom")  //
         // variable ordering
         ("no_reordering", po::bool_switch(&m_values.no_reordering)->default_value(false),
          "Disables automatic reordering during dd construction.")  //
@@ -101,6 +162,12 @@ void option_parser::parse_command_line(int argc, char *argv[]) {
          "the tiebreaker is used for the whole timesetp")  //
         ("force_random_seed", po::bool_switch(&m_values.force_random_seed)->default_value(false),
          "Sets the initial order for the force algorithm to a random permutation and does not use custom order")  //
+        ("force_num_starts", po::value<int>(&m_values.force_num_starts)->default_value(1),
+         "Runs force from this many initial orders on num_threads threads and keeps the order with the lowest total "
+         "span. The first start uses the custom order (unless force_random_seed is set), the others shuffle it")  //
+        ("force_seed", po::value<int>(&m_values.force_seed)->default_value(-1),
+         "Seed for the shuffled initial orders of force. Start i uses force_seed + i. A negative value uses a random "
+         "seed, which is logged")  //
         // variable grouping
         ("group_variables", po::bool_switch(&m_values.group_variables)->default_value(false),
          "Groups the variables for one timestep together")  //
@@ -109,6 +176,8 @@ void option_parser::parse_command_line(int argc, char *argv[]) {
          "(and not all planning variables of a timestep)")  //
         ("group_actions", po::bool_switch(&m_values.group_actions)->default_value(false),
          "Groups the actions for one timestep together. Works with unary and binary encoding")  //
+        ("group_actions_small", po::bool_switch(&m_values.group_actions_small)->default_value(false),
+         "Groups the operator variables of every colour class of the binary parallel encoding together")  //
         // building algorithm
         ("prebuild_goals", po::bool_switch(&m_values.prebuild_goals)->default_value(false),
          "Used to create all goals for the topK track in the beginning")  //
@@ -145,10 +214,67 @@ void option_parser::parse_command_line(int argc, char *argv[]) {
 bool option_parser::check_validity() {
     if ((m_values.encode_cnf + m_values.build_bdd + m_values.build_sdd + m_values.single_minisat +
          m_values.count_minisat + m_values.hack_debug + m_values.cnf_to_bdd + m_values.conflict_graph +
-         m_values.build_bdd_naiv + m_values.build_sdd_naiv) != 1) {
+         m_values.build_bdd_naiv + m_values.build_sdd_naiv + m_values.benchmark_parser +
+         m_values.benchmark_conflict_graph + m_values.benchmark_force_sort) != 1) {
         std::cout << "You have to choose exactly one mode." << std::endl;
         return false;
     }
+    if (m_values.force_num_starts < 1) {
+        std::cout << "force_num_starts has to be at least 1." << std::endl;
+        return false;
+    }
+    if (m_values.colouring_time_budget < 0) {
+        std::cout << "colouring_time_budget can not be negative." << std::endl;
+        return false;
+    }
+    if (m_values.num_threads < 1) {
+        std::cout << "num_threads has to be at least 1." << std::endl;
+        return false;
+    }
+    if (m_values.exists_step &&
+        (m_values.parallel_plan || m_values.binary_encoding || m_values.binary_parallel || m_values.group_pre_eff)) {
+        std::cout << "exists_step can not be combined with parallel_plan, binary_encoding, binary_parallel or "
+                     "group_pre_eff."
+                  << std::endl;
+        return false;
+    }
+    if (m_values.stream_primitives &&
+        (!m_values.linear || !m_values.clause_order_custom || m_values.preprocess || m_values.reverse_order)) {
+        std::cout << "stream_primitives needs linear and clause_order_custom and can not be combined with preprocess "
+                     "or reverse_order."
+                  << std::endl;
+        return false;
+    }
+    if (!code_assignment::is_valid_strategy(m_values.binary_code_assignment)) {
+        std::cout << "binary_code_assignment has to be plain, gray or cluster." << std::endl;
+        return false;
+    }
+    if (m_values.adaptive_encoding && m_values.binary_parallel) {
+        std::cout << "adaptive_encoding can not be combined with binary_parallel." << std::endl;
+        return false;
+    }
+    if (m_values.commutation_reduction &&
+        (m_values.parallel_plan || m_values.exists_step || m_values.binary_encoding || m_values.binary_parallel ||
+         m_values.use_layer_permutation || m_values.layer_expo)) {
+        std::cout << "commutation_reduction orders operators of consecutive timesteps and can not be combined with "
+                     "parallel_plan, exists_step, binary_encoding, binary_parallel, use_layer_permutation or layer_expo."
+                  << std::endl;
+        return false;
+    }
+    if (m_values.symmetry_breaking &&
+        (m_values.parallel_plan || m_values.exists_step || m_values.binary_encoding || m_values.binary_parallel ||
+         m_values.commutation_reduction || m_values.use_layer_permutation || m_values.layer_expo)) {
+        std::cout << "symmetry_breaking can not be combined with parallel_plan, exists_step, binary_encoding, "
+                     "binary_parallel, commutation_reduction, use_layer_permutation or layer_expo."
+                  << std::endl;
+        return false;
+    }
+    if (m_values.reachability_pruning && (m_values.use_layer_permutation || m_values.layer_expo)) {
+        std::cout << "reachability_pruning creates different variables for every timestep and can not be used with "
+                     "use_layer_permutation or layer_expo."
+                  << std::endl;
+        return false;
+    }
     return true;
 }
 
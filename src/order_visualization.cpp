@@ -47,21 +47,27 @@ void visualize_var_order(std::vector<int> &var_order, std::vector<planning_logic
     double total_span = 0;
 
     // calculate upper layer (clauses) and lines
+    // the affected variables are needed multiple times
+    std::vector<std::vector<int>> affected_variables(primitives.size());
+    for (int i = 0; i < primitives.size(); i++) {
+        affected_variables[i] = primitives[i].get_affected_variables();
+    }
+
     for (int i = 0; i < primitives.size(); i++) {
         double average_pos = 0;
         double min_span = var_order.size() + 2;
         double max_span = 0;
         double span;
 
-        for (int a = 0; a < primitives[i].get_affected_variables().size(); a++) {
-            double var_pos = var_to_pos[primitives[i].get_affected_variables()[a]];
+        for (int a = 0; a < affected_variables[i].size(); a++) {
+            double var_pos = var_to_pos[affected_variables[i][a]];
             min_span = std::min(min_span, var_pos);
             max_span = std::max(max_span, var_pos);
             average_pos += var_pos;
         }
 
         // calculate hight/width from span and average_pos
-        average_pos /= primitives[i].get_affected_variables().size();
+        average_pos /= affected_variables[i].size();
         average_pos += randMToN(-0.2, 0.2);  // random pertubation to avoid overlap
         span = max_span - min_span;
 
@@ -126,15 +132,15 @@ void visualize_var_order(std::vector<int> &var_order, std::vector<planning_logic
 
         double min_span = var_order.size() + 2;
         double max_span = 0;
-        for (int a = 0; a < primitives[i].get_affected_variables().size(); a++) {
-            double var_pos = var_to_pos[primitives[i].get_affected_variables()[a]];
+        for (int a = 0; a < affected_variables[i].size(); a++) {
+            double var_pos = var_to_pos[affected_variables[i][a]];
             min_span = std::min(min_span, var_pos);
             max_span = std::max(max_span, var_pos);
         }
         double span = (std::min(max_span-min_span, 100.0) / 100) * 255;
 
-        for (int a = 0; a < primitives[i].get_affected_variables().size(); a++) {
-            int neighbour = primitives[i].get_affected_variables()[a];
+        for (int a = 0; a < affected_variables[i].size(); a++) {
+            int neighbour = affected_variables[i][a];
             // determine colour of line (colour is dependent on the span of a clause, capped at 100)
 
             draw_line(file, primitive_positions[i].first, primitive_positions[i].second, 
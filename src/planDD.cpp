@@ -6,6 +6,7 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <chrono>
 #include <random>
 
 #include "bdd_container.h"
@@ -15,6 +16,8 @@
 #include "dd_builder_variable_order.h"
 #include "encoder_basic.h"
 #include "encoder_binary_parallel.h"
+#include "encoder_exists_step.h"
+#include "force.h"
 #include "graph.h"
 #include "logging.h"
 #include "order_visualization.h"
@@ -78,6 +81,18 @@ int main(int argc, char *argv[]) {
         return planDD::count_minisat(options.m_values);
     }
 
+    if (options.m_values.benchmark_parser) {
+        return planDD::benchmark_parser(options.m_values);
+    }
+
+    if (options.m_values.benchmark_conflict_graph) {
+        return planDD::benchmark_conflict_graph(options.m_values);
+    }
+
+    if (options.m_values.benchmark_force_sort) {
+        return planDD::benchmark_force_sort(options.m_values);
+    }
+
     return -1;
 }
 
@@ -135,14 +150,11 @@ int planDD::conflict_graph(option_values opt_values) {
 
     LOG_MESSAGE(log_level::info) << "Starting to construct conflict graph";
 
-    graph::undirected_graph complement_graph = parser.m_sas_problem.construct_complement_action_conflic_graph();
-    std::vector<int> colouring = graph::approximate_colouring(complement_graph);
-    int max = 0;
-    for (int i = 0; i < colouring.size(); i++) {
-        max = colouring[i] > max ? colouring[i] : max;
-    }
+    graph::undirected_graph complement_graph =
+        parser.m_sas_problem.construct_complement_action_conflic_graph(opt_values.num_threads);
+    std::vector<int> colouring = graph::improved_colouring(complement_graph, opt_values.colouring_time_budget);
 
-    LOG_MESSAGE(log_level::info) << "Num colours: " << max + 1;
+    LOG_MESSAGE(log_level::info) << "Num colours: " << graph::num_colours(colouring);
 
     graph::write_to_file_with_colouring("graph.dot", complement_graph, colouring, false);
 
@@ -159,16 +171,21 @@ int planDD::build_bdd(option_values opt_values) {
         return 0;
     }
 
-    encoder::encoder_abstract *encoder;
-    if (opt_values.binary_parallel) {
-        graph::undirected_graph conflict_graph = parser.m_sas_problem.construct_complement_action_conflic_graph();
-        encoder = new encoder::binary_parallel(opt_values, parser.m_sas_problem, conflict_graph);
-    } else {
-        encoder = new encoder::encoder_basic(opt_values, parser.m_sas_problem);
+    if (opt_values.simplify_task) {
+        // without sequential plans, removing effects or merging operators changes which operators can be parallel
+        bool sequential = !opt_values.parallel_plan && !opt_values.binary_parallel && !opt_values.exists_step;
+        parser.m_sas_problem.simplify(sequential, sequential && !opt_values.binary_encoding);
     }
 
-    bdd_container builder(1);
+    if (opt_values.h2_mutexes) {
+        parser.m_sas_problem.add_h2_mutexes();
+    }
 
+    if (opt_values.symmetry_breaking) {
+        parser.m_sas_problem.find_symmetric_objects();
+    }
+
+    // the encoder needs the number of timesteps for the reachability pruning
     if (opt_values.use_fd) {
         int min_plan_length = get_plan_length("fd_output.txt");
         opt_values.timesteps = min_plan_length;
@@ -178,6 +195,19 @@ int planDD::build_bdd(option_values opt_values) {
         }
     }
 
+    encoder::encoder_abstract *encoder;
+    if (opt_values.binary_parallel) {
+        graph::undirected_graph conflict_graph =
+            parser.m_sas_problem.construct_complement_action_conflic_graph(opt_values.num_threads);
+        encoder = new encoder::binary_parallel(opt_values, parser.m_sas_problem, conflict_graph);
+    } else if (opt_values.exists_step) {
+        encoder = new encoder::encoder_exists_step(opt_values, parser.m_sas_problem);
+    } else {
+        encoder = new encoder::encoder_basic(opt_values, parser.m_sas_problem);
+    }
+
+    bdd_container builder(1);
+
     if (opt_values.timesteps >= 0) {
         variable_creation::create_variables_for_first_t_steps(opt_values.timesteps, *encoder, builder, opt_values);
 
@@ -197,6 +227,34 @@ int planDD::build_bdd(option_values opt_values) {
 
     builder.print_info();
 
+    double num_plans = builder.count_num_solutions(0);
+    if (!parser.m_sas_problem.m_operator_multiplicities.empty()) {
+        // each merged operator stands for multiple operators of the original problem
+        std::vector<double> weights;
+        std::vector<int> &multiplicities = parser.m_sas_problem.m_operator_multiplicities;
+        for (int t = 0; t < encoder->m_symbol_map.get_num_variables(); t++) {
+            bool found = false;
+            for (int op = 0; op < multiplicities.size(); op++) {
+                int index = encoder->m_symbol_map.get_variable_index_without_adding(planning_logic::variable_plan_op, t, op);
+                if (index < 0 || index == encoder->m_symbol_map.get_false_variable()) {
+                    continue;
+                }
+                found = true;
+                weights.resize(std::max((int)weights.size(), index + 1), 1);
+                weights[index] = multiplicities[op];
+            }
+            if (!found) {
+                break;
+            }
+        }
+        num_plans = builder.count_weighted_solutions(0, weights);
+        LOG_MESSAGE(log_level::info) << "Number of plans with the multiplicities of merged operators: " << num_plans;
+    }
+    if (!parser.m_sas_problem.m_object_classes.empty()) {
+        LOG_MESSAGE(log_level::info) << "Number of plans including the symmetric plans: "
+                                     << num_plans * parser.m_sas_problem.symmetry_factor();
+    }
+
     if (opt_values.query_random_plans) {
         int num_solutions = builder.count_num_solutions(0);
         num_solutions = std::max(0, num_solutions);
@@ -289,6 +347,20 @@ int planDD::build_sdd(option_values opt_values) {
         return 0;
     }
 
+    if (opt_values.simplify_task) {
+        // the sdd container can not count with the multiplicities of merged operators
+        parser.m_sas_problem.simplify(!opt_values.parallel_plan && !opt_values.binary_parallel && !opt_values.exists_step,
+                                      false);
+    }
+
+    if (opt_values.h2_mutexes) {
+        parser.m_sas_problem.add_h2_mutexes();
+    }
+
+    if (opt_values.symmetry_breaking) {
+        parser.m_sas_problem.find_symmetric_objects();
+    }
+
     if (opt_values.use_fd) {
         int min_plan_length = get_plan_length("fd_output.txt");
         opt_values.timesteps = min_plan_length;
@@ -298,8 +370,17 @@ int planDD::build_sdd(option_values opt_values) {
         }
     }
 
-    encoder::encoder_basic encoder(opt_values, parser.m_sas_problem);
-    sdd_container container(1, encoder.num_variables_in_t_timesteps(opt_values.timesteps));
+    encoder::encoder_abstract *encoder;
+    if (opt_values.binary_parallel) {
+        graph::undirected_graph conflict_graph =
+            parser.m_sas_problem.construct_complement_action_conflic_graph(opt_values.num_threads);
+        encoder = new encoder::binary_parallel(opt_values, parser.m_sas_problem, conflict_graph);
+    } else if (opt_values.exists_step) {
+        encoder = new encoder::encoder_exists_step(opt_values, parser.m_sas_problem);
+    } else {
+        encoder = new encoder::encoder_basic(opt_values, parser.m_sas_problem);
+    }
+    sdd_container container(1, encoder->num_variables_in_t_timesteps(opt_values.timesteps));
 
     if (opt_values.no_reordering) {
         container.disable_reordering();
@@ -307,14 +388,26 @@ int planDD::build_sdd(option_values opt_values) {
         container.enable_reordering();
     }
 
-    variable_creation::create_variables_for_first_t_steps(opt_values.timesteps, encoder, container, opt_values);
-    std::vector<planning_logic::logic_primitive> all_primitives = conjoin_order::order_all_clauses(encoder, opt_values);
+    variable_creation::create_variables_for_first_t_steps(opt_values.timesteps, *encoder, container, opt_values);
+    if (opt_values.stream_primitives) {
+        LOG_MESSAGE(log_level::info) << "Start building sdd";
+        conjoin_order::primitive_stream stream(*encoder, opt_values);
+        dd_builder::conjoin_primitive_stream(container, stream);
+    } else {
+        std::vector<planning_logic::logic_primitive> all_primitives =
+            conjoin_order::order_all_clauses(*encoder, opt_values);
 
-    LOG_MESSAGE(log_level::info) << "Start building sdd";
+        LOG_MESSAGE(log_level::info) << "Start building sdd";
 
-    dd_builder::conjoin_primitives_linear(container, all_primitives);
+        dd_builder::conjoin_primitives_linear(container, all_primitives);
+    }
     container.print_info();
+    if (!parser.m_sas_problem.m_object_classes.empty()) {
+        LOG_MESSAGE(log_level::info) << "Number of plans including the symmetric plans: "
+                                     << container.count_num_solutions(0) * parser.m_sas_problem.symmetry_factor();
+    }
 
+    delete encoder;
     return 0;
 }
 
@@ -442,3 +535,146 @@ int planDD::count_minisat(option_values opt_values) {
 */
     return 0;
 }
+
+int planDD::benchmark_parser(option_values opt_values) {
+    if (opt_values.sas_file == "-") {
+        LOG_MESSAGE(log_level::error) << "The parser benchmark needs a file, it can not read stdin multiple times";
+        return 0;
+    }
+
+    double time_tokenizer = 0, time_legacy = 0;
+    for (int i = 0; i < opt_values.benchmark_runs; i++) {
+        sas_parser tokenizer_parser(opt_values.sas_file);
+        auto start = std::chrono::steady_clock::now();
+        if (tokenizer_parser.start_parsing() == -1) {
+            LOG_MESSAGE(log_level::error) << "Error while parsing sas_file";
+            return 0;
+        }
+        auto middle = std::chrono::steady_clock::now();
+        sas_parser legacy_parser(opt_values.sas_file);
+        if (legacy_parser.start_parsing_legacy() == -1) {
+            LOG_MESSAGE(log_level::error) << "Error while parsing sas_file with the legacy parser";
+            return 0;
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        time_tokenizer += std::chrono::duration<double, std::milli>(middle - start).count();
+        time_legacy += std::chrono::duration<double, std::milli>(end - middle).count();
+
+        // both parsers have to agree on the problem
+        sas_problem &a = tokenizer_parser.m_sas_problem;
+        sas_problem &b = legacy_parser.m_sas_problem;
+        bool equal = a.m_variabels.size() == b.m_variabels.size() && a.m_operators.size() == b.m_operators.size() &&
+                     a.m_mutex_groups == b.m_mutex_groups && a.m_initial_state == b.m_initial_state &&
+                     a.m_goal == b.m_goal;
+        for (int op = 0; equal && op < a.m_operators.size(); op++) {
+            equal = a.m_operators[op].m_name == b.m_operators[op].m_name &&
+                    a.m_operators[op].m_effects == b.m_operators[op].m_effects;
+        }
+        for (int v = 0; equal && v < a.m_variabels.size(); v++) {
+            equal = a.m_variabels[v].m_name == b.m_variabels[v].m_name &&
+                    a.m_variabels[v].m_symbolic_names == b.m_variabels[v].m_symbolic_names;
+        }
+        if (!equal) {
+            LOG_MESSAGE(log_level::error) << "Tokenizer and legacy parser produced different problems";
+            return 0;
+        }
+    }
+
+    LOG_MESSAGE(log_level::info) << "Average parse time over " << opt_values.benchmark_runs
+                                 << " runs: tokenizer " << time_tokenizer / opt_values.benchmark_runs
+                                 << "ms, legacy parser " << time_legacy / opt_values.benchmark_runs << "ms";
+
+    return 0;
+}
+
+int planDD::benchmark_conflict_graph(option_values opt_values) {
+    sas_parser parser(opt_values.sas_file);
+    if (parser.start_parsing() == -1) {
+        LOG_MESSAGE(log_level::error) << "Error while parsing sas_file";
+        return 0;
+    }
+    sas_problem &problem = parser.m_sas_problem;
+
+    double time_buckets = 0, time_pairwise = 0;
+    for (int i = 0; i < opt_values.benchmark_runs; i++) {
+        auto start = std::chrono::steady_clock::now();
+        graph::undirected_graph bucket_graph = problem.construct_action_conflic_graph(opt_values.num_threads);
+        bucket_graph.get_num_edges();
+        auto middle = std::chrono::steady_clock::now();
+        graph::undirected_graph pairwise_graph = problem.construct_action_conflic_graph_pairwise();
+        pairwise_graph.get_num_edges();
+        auto end = std::chrono::steady_clock::now();
+
+        time_buckets += std::chrono::duration<double, std::milli>(middle - start).count();
+        time_pairwise += std::chrono::duration<double, std::milli>(end - middle).count();
+
+        // both constructions have to agree on the graph
+        for (int op = 0; op < problem.m_operators.size(); op++) {
+            graph::neighbour_range a = bucket_graph.neighbours(op);
+            graph::neighbour_range b = pairwise_graph.neighbours(op);
+            if (!std::equal(a.begin(), a.end(), b.begin(), b.end())) {
+                LOG_MESSAGE(log_level::error) << "Bucket and pairwise construction produced different conflict graphs";
+                return 0;
+            }
+        }
+    }
+
+    LOG_MESSAGE(log_level::info) << "Average conflict graph construction time for " << problem.m_operators.size()
+                                 << " operators over " << opt_values.benchmark_runs << " runs: buckets with "
+                                 << opt_values.num_threads << " threads " << time_buckets / opt_values.benchmark_runs
+                                 << "ms, pairwise " << time_pairwise / opt_values.benchmark_runs << "ms";
+
+    return 0;
+}
+
+int planDD::benchmark_force_sort(option_values opt_values) {
+    unsigned int seed = opt_values.force_seed < 0 ? std::random_device{}() : opt_values.force_seed;
+    std::mt19937 rng(seed);
+    LOG_MESSAGE(log_level::info) << "Comparing the force sorts with seed " << seed;
+
+    std::vector<int> sorted_nodes, node_buffer;
+    std::vector<uint32_t> keys, key_buffer;
+    for (int num_nodes : {0, 1, 100, 10000, 1000000}) {
+        // positions like in force: the average over the integer centers of gravity of 0 to 4 edges
+        // with 0 edges the position is 0, so there are many ties
+        std::vector<double> position(num_nodes);
+        double time_radix = 0, time_std = 0;
+        for (int run = 0; run < opt_values.benchmark_runs; run++) {
+            for (int v = 0; v < num_nodes; v++) {
+                int num_edges = rng() % 5;
+                int64_t pos_sum = 0;
+                for (int e = 0; e < num_edges; e++) {
+                    pos_sum += rng() % num_nodes;
+                }
+                position[v] = num_edges != 0 ? (double)pos_sum / num_edges : 0.0;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            variable_order::sort_by_position(position, sorted_nodes, keys, key_buffer, node_buffer);
+            auto middle = std::chrono::steady_clock::now();
+            std::vector<std::pair<double, int>> pos_node_pairs;
+            for (int v = 0; v < num_nodes; v++) {
+                pos_node_pairs.push_back(std::make_pair(position[v], v));
+            }
+            std::sort(pos_node_pairs.begin(), pos_node_pairs.end());
+            auto end = std::chrono::steady_clock::now();
+
+            time_radix += std::chrono::duration<double, std::milli>(middle - start).count();
+            time_std += std::chrono::duration<double, std::milli>(end - middle).count();
+
+            // both sorts have to agree on the order
+            for (int i = 0; i < num_nodes; i++) {
+                if (sorted_nodes[i] != pos_node_pairs[i].second) {
+                    LOG_MESSAGE(log_level::error) << "Radix sort and std::sort disagree at position " << i << " of "
+                                                  << num_nodes << " nodes";
+                    return 0;
+                }
+            }
+        }
+        LOG_MESSAGE(log_level::info) << "Average sort time for " << num_nodes << " nodes over "
+                                     << opt_values.benchmark_runs << " runs: radix " << time_radix / opt_values.benchmark_runs
+                                     << "ms, std::sort " << time_std / opt_values.benchmark_runs << "ms";
+    }
+    return 0;
+}
@@ -1,5 +1,7 @@
 #include "plan_to_cnf_map.h"
 
+#include <cmath>
+
 #include "logging.h"
 namespace planning_logic {
 
@@ -7,32 +9,91 @@ plan_to_cnf_map::plan_to_cnf_map(int num_operators) {
     m_num_operators = num_operators;
     // TODO: i have no idea how save this is, but i am too lazy to check for highest bit
     m_num_op_variables = num_bits_for_binary_var(num_operators);
+
+    m_index_table = std::vector<std::vector<std::vector<std::vector<int>>>>(variable_none + 1);
+    m_blocks = std::vector<std::vector<variable_block>>(variable_none + 1);
+    // the dummy variable 0
+    m_inverse_variable_map.push_back(std::make_tuple(variable_none, -1, -1, -1));
 }
 
-int plan_to_cnf_map::next_used_index() { return m_variable_map.size() + 1; }
+int plan_to_cnf_map::next_used_index() { return m_inverse_variable_map.size(); }
 
 int plan_to_cnf_map::num_bits_for_binary_var(int num_variables) { return (int)std::ceil(std::log2(num_variables)); }
 
+int *plan_to_cnf_map::lookup(variable_tag tag, int timestep, int var_index, int value, bool create) {
+    if (timestep < 0 || var_index < 0 || value < 0) {
+        LOG_MESSAGE(log_level::error) << "Negative variable information tag=" << tag << ", t=" << timestep
+                                      << ", id=" << var_index << ", val=" << value;
+        return nullptr;
+    }
+
+    std::vector<std::vector<std::vector<int>>> &timesteps = m_index_table[tag];
+    if (timestep >= timesteps.size()) {
+        if (!create) return nullptr;
+        timesteps.resize(timestep + 1);
+    }
+    std::vector<std::vector<int>> &variables = timesteps[timestep];
+    if (var_index >= variables.size()) {
+        if (!create) return nullptr;
+        variables.resize(var_index + 1);
+    }
+    std::vector<int> &values = variables[var_index];
+    if (value >= values.size()) {
+        if (!create) return nullptr;
+        values.resize(value + 1, 0);
+    }
+    return &values[value];
+}
+
+void plan_to_cnf_map::set_impossible_variables(std::function<bool(variable_tag, int, int, int)> is_impossible) {
+    m_false_index = get_variable_index(variable_none, 0, 0, 0);
+    m_is_impossible = is_impossible;
+}
+
 int plan_to_cnf_map::get_variable_index(variable_tag tag, int timestep, int var_index, int value) {
-    tagged_variable var = std::make_tuple(tag, timestep, var_index, value);
-    if (m_variable_map.find(var) == m_variable_map.end()) {
+    if (m_is_impossible && m_is_impossible(tag, timestep, var_index, value)) {
+        return m_false_index;
+    }
+    int *entry = lookup(tag, timestep, var_index, value, true);
+    if (entry == nullptr) {
+        return -1;
+    }
+
+    if (*entry == 0) {
         // LOG_MESSAGE(log_level::debug) << "Created new var tag=" << tag << ", t=" << timestep << ", id=" << var_index
         // << ", val=" << value;
-        int size = m_variable_map.size();
-        m_variable_map[var] = size + 1;
+        int new_index = m_inverse_variable_map.size();
+        *entry = new_index;
+        m_inverse_variable_map.push_back(std::make_tuple(tag, timestep, var_index, value));
+
+        // update the information about the block of the variable
+        if (timestep >= m_blocks[tag].size()) {
+            m_blocks[tag].resize(timestep + 1);
+        }
+        variable_block &block = m_blocks[tag][timestep];
+        if (block.m_size == 0) {
+            block.m_first_index = new_index;
+        } else if (block.m_last_index + 1 != new_index) {
+            block.m_is_contiguous = false;
+        }
+        block.m_last_index = new_index;
+        block.m_size++;
+        uint64_t entry_hash = ((uint64_t)var_index << 32) ^ (uint64_t)value;
+        block.m_layout_hash = (block.m_layout_hash ^ entry_hash) * 0x100000001b3ULL + 0x9e3779b97f4a7c15ULL;
     }
 
-    // also add information to the inverted variable map
-    m_inverse_variable_map[m_variable_map[var]] = var;
-    return m_variable_map[var];
+    return *entry;
 }
 
 int plan_to_cnf_map::get_variable_index_without_adding(variable_tag tag, int timestep, int var_index, int value) {
-    tagged_variable var = std::make_tuple(tag, timestep, var_index, value);
-    if (m_variable_map.find(var) == m_variable_map.end()) {
+    if (m_is_impossible && m_is_impossible(tag, timestep, var_index, value)) {
+        return m_false_index;
+    }
+    int *entry = lookup(tag, timestep, var_index, value, false);
+    if (entry == nullptr || *entry == 0) {
         return -1;
     }
-    return m_variable_map[var];
+    return *entry;
 }
 
 int plan_to_cnf_map::get_variable_index(variable_tag tag, int timestep, int var_index) {
@@ -43,8 +104,16 @@ int plan_to_cnf_map::get_variable_index_without_adding(variable_tag tag, int tim
     return get_variable_index_without_adding(tag, timestep, var_index, 0);
 }
 
+void plan_to_cnf_map::set_binary_codes(std::vector<int> op_codes, std::vector<std::vector<int>> var_codes) {
+    m_op_codes = op_codes;
+    m_var_codes = var_codes;
+}
+
 std::vector<int> plan_to_cnf_map::get_variable_index_for_op_binary(int timestep, int op_index) {
     std::vector<int> result;
+    if (!m_op_codes.empty()) {
+        op_index = m_op_codes[op_index];
+    }
     // get log many variables for the operator
     for (int i = 0; i < m_num_op_variables; i++) {
         result.push_back(get_variable_index(variable_plan_binary_op, timestep, i));
@@ -64,6 +133,9 @@ std::vector<int> plan_to_cnf_map::get_variable_index_for_op_binary(int timestep,
 std::vector<int> plan_to_cnf_map::get_variable_index_for_var_binary(int timestep, int var_index, int var_value,
                                                                     int var_size) {
     std::vector<int> result;
+    if (!m_var_codes.empty()) {
+        var_value = m_var_codes[var_index][var_value];
+    }
     int binary_size = num_bits_for_binary_var(var_size);
     // get log many variables for the operator
     for (int i = 0; i < binary_size; i++) {
@@ -84,6 +156,9 @@ std::vector<int> plan_to_cnf_map::get_variable_index_for_var_binary(int timestep
 std::vector<int> plan_to_cnf_map::get_variable_index_binary(variable_tag tag, int timestep, int group_index, int value,
                                                             int size) {
     std::vector<int> result;
+    if (tag == variable_plan_binary_var && !m_var_codes.empty()) {
+        value = m_var_codes[group_index][value];
+    }
     int binary_size = num_bits_for_binary_var(size);
     for (int i = 0; i < binary_size; i++) {
         result.push_back(get_variable_index(tag, timestep, group_index, i));
@@ -101,50 +176,150 @@ std::vector<int> plan_to_cnf_map::get_variable_index_binary(variable_tag tag, in
 }
 
 tagged_variable plan_to_cnf_map::get_planning_info_for_variable(int index) {
-    if (m_inverse_variable_map.find(index) == m_inverse_variable_map.end()) {
+    if (index <= 0 || index >= m_inverse_variable_map.size()) {
         return std::make_tuple(variable_none, -1, -1, -1);
     }
     return m_inverse_variable_map[index];
 }
 
+bool plan_to_cnf_map::may_be_offset(variable_block &from, variable_block &to) {
+    return from.m_is_contiguous && to.m_is_contiguous && from.m_size == to.m_size &&
+           from.m_layout_hash == to.m_layout_hash;
+}
+
+bool plan_to_cnf_map::is_shifted_variable(int from_index, int to_index, int t_to) {
+    if (to_index <= 0 || to_index >= m_inverse_variable_map.size()) {
+        return false;
+    }
+    tagged_variable &from = m_inverse_variable_map[from_index];
+    tagged_variable &to = m_inverse_variable_map[to_index];
+    return std::get<0>(from) == std::get<0>(to) && std::get<1>(to) == t_to && std::get<2>(from) == std::get<2>(to) &&
+           std::get<3>(from) == std::get<3>(to);
+}
+
+int plan_to_cnf_map::get_shifted_variable_index(int index, int t_diff) {
+    tagged_variable &info = m_inverse_variable_map[index];
+    variable_tag tag = std::get<0>(info);
+    int t = std::get<1>(info);
+    int t_to = t + t_diff;
+
+    if (t_to < m_blocks[tag].size()) {
+        variable_block &from = m_blocks[tag][t];
+        variable_block &to = m_blocks[tag][t_to];
+        int shifted = index - from.m_first_index + to.m_first_index;
+        if (may_be_offset(from, to) && is_shifted_variable(index, shifted, t_to)) {
+            return shifted;
+        }
+    }
+    return get_variable_index(tag, t_to, std::get<2>(info), std::get<3>(info));
+}
+
+std::vector<std::tuple<tagged_variable, int>> plan_to_cnf_map::get_variables_in_key_order() {
+    std::vector<std::tuple<tagged_variable, int>> result;
+    result.reserve(get_num_variables());
+
+    for (int tag_int = variable_plan_var; tag_int <= variable_none; tag_int++) {
+        variable_tag tag = static_cast<variable_tag>(tag_int);
+        for (int t = 0; t < m_index_table[tag].size(); t++) {
+            for (int v = 0; v < m_index_table[tag][t].size(); v++) {
+                for (int val = 0; val < m_index_table[tag][t][v].size(); val++) {
+                    int index = m_index_table[tag][t][v][val];
+                    if (index != 0) {
+                        result.push_back(std::make_tuple(std::make_tuple(tag, t, v, val), index));
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+int plan_to_cnf_map::permuted_timestep(variable_tag tag, int t, int t_diff, int num_timesteps) {
+    int modulus;
+    switch (tag) {
+        case variable_plan_var:
+        case variable_plan_binary_var:
+        case variable_h_amost_variable:
+        case variable_h_amost_mutex:
+        case variable_h_symmetry:
+            // variables are relevant for t+1 timesteps
+            modulus = num_timesteps + 1;
+            break;
+        case variable_plan_op:
+        case variable_plan_binary_op:
+        case variable_h_amost_operator:
+        case variable_h_exists_step:
+            // operators are only relevant for t timesteps
+            modulus = num_timesteps;
+            break;
+        default:
+            return t;
+    }
+    if (modulus <= 0) {
+        return t;
+    }
+    // also allow negative t_diffs
+    return ((t + t_diff) % modulus + modulus) % modulus;
+}
+
 std::vector<int> plan_to_cnf_map::calculate_permutation_by_timesteps(int t_diff, int num_timesteps) {
-    LOG_MESSAGE(log_level::info) << "Calculating permutation of size " << m_variable_map.size() + 1
+    LOG_MESSAGE(log_level::info) << "Calculating permutation of size " << m_inverse_variable_map.size()
                                  << " for t_diff=" << t_diff;
 
-    std::vector<int> from_to_index(m_variable_map.size() + 1);
+    std::vector<int> from_to_index(m_inverse_variable_map.size());
     from_to_index[0] = 0;  // dummy variable does not get permuted
 
-    // calculate the mapping
-    for (std::map<tagged_variable, int>::iterator iter = m_variable_map.begin(); iter != m_variable_map.end(); ++iter) {
-        tagged_variable tagged_var = iter->first;
-        variable_tag tag = std::get<0>(tagged_var);
-        int t = std::get<1>(tagged_var);
-        int t_to;
+    int num_missing = 0;
+    for (int tag_int = variable_plan_var; tag_int <= variable_none; tag_int++) {
+        variable_tag tag = static_cast<variable_tag>(tag_int);
+        for (int t = 0; t < m_blocks[tag].size(); t++) {
+            variable_block &from = m_blocks[tag][t];
+            if (from.m_size == 0) {
+                continue;
+            }
+            int t_to = permuted_timestep(tag, t, t_diff, num_timesteps);
 
-        // also allow negative t_diffs
-        if (tag == variable_plan_var) {
-            // variables are relevant for t+1 timesteps
-            int modulus = num_timesteps + 1;
-            t_to = (modulus + t + t_diff) % modulus;
-        }
-        if (tag == variable_plan_op) {
-            // operators are only relevant for t timesteps
-            int modulus = num_timesteps;
-            t_to = (modulus + t + t_diff) % modulus;
+            // fast path: both blocks have the same layout and the permutation is an offset
+            if (t_to < m_blocks[tag].size()) {
+                variable_block &to = m_blocks[tag][t_to];
+                int offset = to.m_first_index - from.m_first_index;
+                bool is_offset = may_be_offset(from, to);
+                for (int i = from.m_first_index; i <= from.m_last_index && is_offset; i++) {
+                    is_offset = is_shifted_variable(i, i + offset, t_to);
+                }
+                if (is_offset) {
+                    for (int i = from.m_first_index; i <= from.m_last_index; i++) {
+                        from_to_index[i] = i + offset;
+                    }
+                    continue;
+                }
+            }
+
+            // slow path: look up every variable
+            for (int v = 0; v < m_index_table[tag][t].size(); v++) {
+                for (int val = 0; val < m_index_table[tag][t][v].size(); val++) {
+                    int index = m_index_table[tag][t][v][val];
+                    if (index == 0) {
+                        continue;
+                    }
+                    int target = get_variable_index_without_adding(tag, t_to, v, val);
+                    if (target == -1) {
+                        num_missing++;
+                        target = index;
+                    }
+                    from_to_index[index] = target;
+                }
+            }
         }
+    }
 
-        tagged_variable tagged_var_to = tagged_var;
-        std::get<1>(tagged_var_to) = t_to;
-        from_to_index[m_variable_map[tagged_var]] = m_variable_map[tagged_var_to];
+    if (num_missing > 0) {
+        LOG_MESSAGE(log_level::error) << num_missing << " variables have no counterpart in the permuted timestep";
     }
 
     return from_to_index;
 }
 
-int plan_to_cnf_map::get_num_variables() { return m_variable_map.size(); }
-
-int num_variables_in_t_timesteps(int t){
-    return 0;
-}
+int plan_to_cnf_map::get_num_variables() { return m_inverse_variable_map.size() - 1; }
 
-}  // namespace planning_logic
\ No newline at end of file
+}  // namespace planning_logic
@@ -0,0 +1,442 @@
+#include "preprocessing.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <set>
+#include <tuple>
+
+#include "logging.h"
+
+using namespace planning_logic;
+
+namespace preprocessing {
+
+namespace {
+
+// result of simplifying a single primitive
+enum simplify_status {
+    status_open,       // the primitive still constrains the formula
+    status_satisfied,  // the primitive is true under the assignment and can be removed
+    status_conflict,   // the primitive is false under the assignment
+};
+
+class unit_propagator {
+   public:
+    // 1: true, -1: false, 0: unassigned
+    std::vector<int> m_values;
+    // the assigned literals with the primitive they came from
+    std::vector<std::pair<int, int>> m_units;
+    bool m_conflict = false;
+
+    unit_propagator(int num_variables) : m_values(num_variables + 1, 0) {}
+
+    int value(int literal) {
+        int v = m_values[std::abs(literal)];
+        return literal < 0 ? -v : v;
+    }
+
+    void assign(int literal, int source) {
+        int current = value(literal);
+        if (current == -1) {
+            m_conflict = true;
+        } else if (current == 0) {
+            m_values[std::abs(literal)] = literal < 0 ? -1 : 1;
+            m_units.push_back(std::make_pair(literal, source));
+        }
+    }
+
+    // removes false literals. Returns true if a literal is true
+    bool reduce_clause(std::vector<int> &clause) {
+        int kept = 0;
+        for (int l : clause) {
+            int v = value(l);
+            if (v == 1) {
+                return true;
+            }
+            if (v == 0) {
+                clause[kept++] = l;
+            }
+        }
+        clause.resize(kept);
+        return false;
+    }
+
+    // removes true literals. Returns false if a literal is false
+    bool reduce_cube(std::vector<int> &cube) {
+        int kept = 0;
+        for (int l : cube) {
+            int v = value(l);
+            if (v == -1) {
+                return false;
+            }
+            if (v == 0) {
+                cube[kept++] = l;
+            }
+        }
+        cube.resize(kept);
+        return true;
+    }
+
+    // removes false terms and true literals of a dnf
+    simplify_status reduce_dnf(std::vector<std::vector<int>> &dnf, int source) {
+        int kept = 0;
+        for (int i = 0; i < dnf.size(); i++) {
+            if (!reduce_cube(dnf[i])) {
+                continue;
+            }
+            if (dnf[i].empty()) {
+                return status_satisfied;
+            }
+            dnf[kept++] = dnf[i];
+        }
+        dnf.resize(kept);
+        if (dnf.empty()) {
+            return status_conflict;
+        }
+        if (dnf.size() == 1) {
+            // a single cube
+            for (int l : dnf[0]) {
+                assign(l, source);
+            }
+            return status_satisfied;
+        }
+        return status_open;
+    }
+
+    simplify_status simplify(logic_primitive &primitive, int source) {
+        switch (primitive.m_type) {
+            case logic_clause: {
+                if (reduce_clause(primitive.m_data)) {
+                    return status_satisfied;
+                }
+                if (primitive.m_data.empty()) {
+                    return status_conflict;
+                }
+                if (primitive.m_data.size() == 1) {
+                    assign(primitive.m_data[0], source);
+                    return status_satisfied;
+                }
+                return status_open;
+            }
+            case logic_dnf: {
+                simplify_status status = reduce_dnf(primitive.m_dnf_data, source);
+                if (status != status_open) {
+                    return status;
+                }
+                // a dnf of single literals is a clause
+                bool is_clause = true;
+                for (std::vector<int> &term : primitive.m_dnf_data) {
+                    is_clause = is_clause && term.size() == 1;
+                }
+                if (is_clause) {
+                    primitive.m_type = logic_clause;
+                    for (std::vector<int> &term : primitive.m_dnf_data) {
+                        primitive.m_data.push_back(term[0]);
+                    }
+                    primitive.m_dnf_data.clear();
+                }
+                return status_open;
+            }
+            case logic_eo:
+            case logic_amo: {
+                int true_literal = 0;
+                for (int l : primitive.m_data) {
+                    if (value(l) == 1) {
+                        if (true_literal != 0) {
+                            return status_conflict;
+                        }
+                        true_literal = l;
+                    }
+                }
+                if (true_literal != 0) {
+                    for (int l : primitive.m_data) {
+                        if (l != true_literal) {
+                            assign(-l, source);
+                        }
+                    }
+                    return status_satisfied;
+                }
+                reduce_clause(primitive.m_data);
+                if (primitive.m_type == logic_amo) {
+                    return primitive.m_data.size() <= 1 ? status_satisfied : status_open;
+                }
+                if (primitive.m_data.empty()) {
+                    return status_conflict;
+                }
+                if (primitive.m_data.size() == 1) {
+                    assign(primitive.m_data[0], source);
+                    return status_satisfied;
+                }
+                return status_open;
+            }
+            case logic_implication: {
+                std::vector<int> &antecedent = primitive.m_dnf_data[0];
+                std::vector<int> &consequent = primitive.m_dnf_data[1];
+                if (!reduce_cube(antecedent)) {
+                    return status_satisfied;
+                }
+                if (!reduce_cube(consequent)) {
+                    // the antecedent has to be false
+                    std::vector<int> clause;
+                    for (int l : antecedent) {
+                        clause.push_back(-l);
+                    }
+                    primitive.m_type = logic_clause;
+                    primitive.m_data = clause;
+                    primitive.m_dnf_data.clear();
+                    return simplify(primitive, source);
+                }
+                if (consequent.empty()) {
+                    return status_satisfied;
+                }
+                if (antecedent.empty()) {
+                    for (int l : consequent) {
+                        assign(l, source);
+                    }
+                    return status_satisfied;
+                }
+                return status_open;
+            }
+            case logic_transition: {
+                // simplify every dnf on its own
+                std::vector<std::vector<int>> result;
+                std::vector<int> result_offsets;
+                for (int d = 0; d + 1 < primitive.m_dnf_offsets.size(); d++) {
+                    std::vector<std::vector<int>> dnf(primitive.m_dnf_data.begin() + primitive.m_dnf_offsets[d],
+                                                      primitive.m_dnf_data.begin() + primitive.m_dnf_offsets[d + 1]);
+                    simplify_status status = reduce_dnf(dnf, source);
+                    if (status == status_conflict) {
+                        return status_conflict;
+                    }
+                    if (status == status_open) {
+                        result_offsets.push_back(result.size());
+                        result.insert(result.end(), dnf.begin(), dnf.end());
+                    }
+                }
+                result_offsets.push_back(result.size());
+                primitive.m_dnf_data = result;
+                primitive.m_dnf_offsets = result_offsets;
+                if (result_offsets.size() == 1) {
+                    return status_satisfied;
+                }
+                if (result_offsets.size() == 2) {
+                    primitive.m_type = logic_dnf;
+                    primitive.m_dnf_offsets.clear();
+                }
+                return status_open;
+            }
+            default:
+                return status_open;
+        }
+    }
+};
+
+int max_variable(const logic_primitive &primitive) {
+    int result = 0;
+    for (int l : primitive.m_data) {
+        result = std::max(result, std::abs(l));
+    }
+    for (const std::vector<int> &term : primitive.m_dnf_data) {
+        for (int l : term) {
+            result = std::max(result, std::abs(l));
+        }
+    }
+    return result;
+}
+
+// marks clauses that are duplicates of an earlier clause or supersets of another clause
+// the literals of the clauses have to be sorted
+int remove_subsumed_clauses(std::vector<logic_primitive> &primitives, std::vector<bool> &removed,
+                            int num_variables) {
+    std::vector<int> clauses;
+    for (int i = 0; i < primitives.size(); i++) {
+        if (!removed[i] && primitives[i].m_type == logic_clause) {
+            clauses.push_back(i);
+        }
+    }
+
+    // occurrence list for every literal. Literal l has index 2 * |l| + (l < 0)
+    std::vector<std::vector<int>> occurrences(2 * num_variables + 2);
+    for (int c : clauses) {
+        for (int l : primitives[c].m_data) {
+            occurrences[2 * std::abs(l) + (l < 0)].push_back(c);
+        }
+    }
+
+    // small clauses can only subsume larger ones. Equal clauses are removed in favour of the first one
+    std::stable_sort(clauses.begin(), clauses.end(),
+                     [&](int a, int b) { return primitives[a].m_data.size() < primitives[b].m_data.size(); });
+
+    int num_removed = 0;
+    for (int c : clauses) {
+        if (removed[c]) {
+            continue;
+        }
+        std::vector<int> &subsuming = primitives[c].m_data;
+        // only the clauses containing the rarest literal can be subsumed
+        int rarest = subsuming[0];
+        for (int l : subsuming) {
+            if (occurrences[2 * std::abs(l) + (l < 0)].size() < occurrences[2 * std::abs(rarest) + (rarest < 0)].size()) {
+                rarest = l;
+            }
+        }
+        for (int d : occurrences[2 * std::abs(rarest) + (rarest < 0)]) {
+            if (d == c || removed[d]) {
+                continue;
+            }
+            std::vector<int> &candidate = primitives[d].m_data;
+            if (candidate.size() < subsuming.size()) {
+                continue;
+            }
+            if (candidate.size() == subsuming.size() && d < c) {
+                // the earlier of two equal clauses is kept
+                continue;
+            }
+            if (std::includes(candidate.begin(), candidate.end(), subsuming.begin(), subsuming.end())) {
+                removed[d] = true;
+                num_removed++;
+            }
+        }
+    }
+    return num_removed;
+}
+}  // namespace
+
+std::vector<logic_primitive> simplify_primitives(std::vector<logic_primitive> &primitives) {
+    LOG_MESSAGE(log_level::info) << "Start preprocessing " << primitives.size() << " primitives";
+
+    int num_variables = 0;
+    for (const logic_primitive &primitive : primitives) {
+        num_variables = std::max(num_variables, max_variable(primitive));
+    }
+
+    std::vector<logic_primitive> simplified = primitives;
+    std::vector<bool> removed(simplified.size(), false);
+    unit_propagator propagator(num_variables);
+
+    // propagate until no new units are found
+    int num_units = -1;
+    while (num_units != propagator.m_units.size() && !propagator.m_conflict) {
+        num_units = propagator.m_units.size();
+        for (int i = 0; i < simplified.size() && !propagator.m_conflict; i++) {
+            if (removed[i]) {
+                continue;
+            }
+            simplify_status status = propagator.simplify(simplified[i], i);
+            if (status == status_conflict) {
+                propagator.m_conflict = true;
+            } else if (status == status_satisfied) {
+                removed[i] = true;
+            }
+        }
+    }
+    if (propagator.m_conflict) {
+        LOG_MESSAGE(log_level::warning) << "Preprocessing found the formula to be unsatisfiable. Keeping all primitives";
+        return primitives;
+    }
+
+    // remove duplicates and subsumed clauses
+    for (int i = 0; i < simplified.size(); i++) {
+        if (!removed[i] && simplified[i].m_type == logic_clause) {
+            std::sort(simplified[i].m_data.begin(), simplified[i].m_data.end());
+            simplified[i].m_data.erase(std::unique(simplified[i].m_data.begin(), simplified[i].m_data.end()),
+                                       simplified[i].m_data.end());
+        }
+    }
+    int num_subsumed = remove_subsumed_clauses(simplified, removed, num_variables);
+
+    // other duplicate primitives
+    int num_duplicates = 0;
+    std::set<std::tuple<int, std::vector<int>, std::vector<std::vector<int>>, std::vector<int>>> seen;
+    for (int i = 0; i < simplified.size(); i++) {
+        if (removed[i] || simplified[i].m_type == logic_clause) {
+            continue;
+        }
+        if (!seen.insert(std::make_tuple((int)simplified[i].m_type, simplified[i].m_data, simplified[i].m_dnf_data,
+                                         simplified[i].m_dnf_offsets))
+                 .second) {
+            removed[i] = true;
+            num_duplicates++;
+        }
+    }
+
+    // the units are kept as clauses, so the formula stays equivalent
+    std::vector<logic_primitive> result;
+    for (std::pair<int, int> &unit : propagator.m_units) {
+        logic_primitive &source = primitives[unit.second];
+        result.push_back(logic_primitive(logic_clause, source.m_clause_tag, source.m_timestep,
+                                         std::vector<int>(1, unit.first)));
+    }
+    int num_removed = 0;
+    std::vector<bool> occurs(num_variables + 1, false);
+    for (int i = 0; i < simplified.size(); i++) {
+        if (removed[i]) {
+            num_removed++;
+            continue;
+        }
+        result.push_back(simplified[i]);
+    }
+    for (const logic_primitive &primitive : result) {
+        for (int l : primitive.m_data) {
+            occurs[std::abs(l)] = true;
+        }
+        for (const std::vector<int> &term : primitive.m_dnf_data) {
+            for (int l : term) {
+                occurs[std::abs(l)] = true;
+            }
+        }
+    }
+    int num_vanished = 0;
+    for (int v = 1; v <= num_variables; v++) {
+        num_vanished += !occurs[v];
+    }
+
+    // the dd managers create variables on their first use and count the solutions over all created variables.
+    // if the variable with the highest index vanished, a tautology keeps it in the dd manager
+    if (num_variables > 0 && !occurs[num_variables]) {
+        std::vector<int> tautology;
+        tautology.push_back(num_variables);
+        tautology.push_back(-num_variables);
+        result.push_back(logic_primitive(logic_clause, none, 0, tautology));
+    }
+
+    LOG_MESSAGE(log_level::info) << "Preprocessing fixed " << propagator.m_units.size() << " variables and removed "
+                                 << num_removed << " of " << primitives.size() << " primitives (" << num_subsumed
+                                 << " subsumed clauses, " << num_duplicates << " duplicates). " << num_vanished
+                                 << " variables no longer occur in any primitive";
+    return result;
+}
+
+std::vector<logic_primitive> assign_false(std::vector<logic_primitive> &primitives, int variable) {
+    int num_variables = variable;
+    for (const logic_primitive &primitive : primitives) {
+        num_variables = std::max(num_variables, max_variable(primitive));
+    }
+    unit_propagator propagator(num_variables);
+    propagator.assign(-variable, -1);
+
+    std::vector<logic_primitive> result;
+    for (const logic_primitive &original : primitives) {
+        logic_primitive primitive = original;
+        int num_units = propagator.m_units.size();
+        simplify_status status = propagator.simplify(primitive, 0);
+        if (propagator.m_conflict) {
+            // a literal was fixed to both values
+            status = status_conflict;
+            propagator.m_conflict = false;
+        }
+        if (status == status_open) {
+            result.push_back(primitive);
+        } else if (status == status_conflict) {
+            // the primitive can not be satisfied
+            result.push_back(
+                logic_primitive(logic_clause, primitive.m_clause_tag, primitive.m_timestep, std::vector<int>(1, variable)));
+        }
+        for (int i = num_units; i < propagator.m_units.size(); i++) {
+            result.push_back(logic_primitive(logic_clause, primitive.m_clause_tag, primitive.m_timestep,
+                                             std::vector<int>(1, propagator.m_units[i].first)));
+        }
+    }
+    return result;
+}
+}  // namespace preprocessing
@@ -0,0 +1,141 @@
+#include "primitive_store.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace planning_logic {
+
+// FNV-1a style mixing of one integer into the hash
+static inline uint64_t hash_combine(uint64_t hash, int64_t value) {
+    hash ^= (uint64_t)value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    return hash * 0x100000001b3ULL;
+}
+
+static uint64_t hash_primitive(const logic_primitive &primitive) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    hash = hash_combine(hash, primitive.m_type);
+    hash = hash_combine(hash, primitive.m_clause_tag);
+    hash = hash_combine(hash, primitive.m_timestep);
+    for (int l : primitive.m_data) {
+        hash = hash_combine(hash, l);
+    }
+    for (const std::vector<int> &term : primitive.m_dnf_data) {
+        // the size separates the terms
+        hash = hash_combine(hash, -(int64_t)term.size() - 1);
+        for (int l : term) {
+            hash = hash_combine(hash, l);
+        }
+    }
+    for (int offset : primitive.m_dnf_offsets) {
+        hash = hash_combine(hash, offset);
+    }
+    return hash;
+}
+
+primitive_store::primitive_store() {
+    m_literal_offsets.push_back(0);
+    m_segment_offsets.push_back(0);
+    m_support_offsets.push_back(0);
+    m_dnf_bound_offsets.push_back(0);
+}
+
+bool primitive_store::is_equal(int id, const logic_primitive &primitive) {
+    if (m_types[id] != primitive.m_type || m_tags[id] != primitive.m_clause_tag ||
+        m_timesteps[id] != primitive.m_timestep) {
+        return false;
+    }
+    int first_segment = m_segment_offsets[id];
+    if (m_segment_offsets[id + 1] - first_segment != primitive.m_dnf_data.size() + 1) {
+        return false;
+    }
+
+    int begin = m_literal_offsets[id];
+    for (int s = 0; s <= primitive.m_dnf_data.size(); s++) {
+        const std::vector<int> &segment = s == 0 ? primitive.m_data : primitive.m_dnf_data[s - 1];
+        int end = m_segment_ends[first_segment + s];
+        if (end - begin != segment.size() || !std::equal(segment.begin(), segment.end(), m_literals.begin() + begin)) {
+            return false;
+        }
+        begin = end;
+    }
+    int first_bound = m_dnf_bound_offsets[id];
+    return m_dnf_bound_offsets[id + 1] - first_bound == primitive.m_dnf_offsets.size() &&
+           std::equal(primitive.m_dnf_offsets.begin(), primitive.m_dnf_offsets.end(), m_dnf_bounds.begin() + first_bound);
+}
+
+int primitive_store::add_primitive(const logic_primitive &primitive) {
+    uint64_t hash = hash_primitive(primitive);
+    auto range = m_lookup.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (is_equal(it->second, primitive)) {
+            return it->second;
+        }
+    }
+
+    int id = m_types.size();
+    m_types.push_back(primitive.m_type);
+    m_tags.push_back(primitive.m_clause_tag);
+    m_timesteps.push_back(primitive.m_timestep);
+    m_hashes.push_back(hash);
+    m_lookup.emplace(hash, id);
+
+    // literals, split into segments
+    m_literals.insert(m_literals.end(), primitive.m_data.begin(), primitive.m_data.end());
+    m_segment_ends.push_back(m_literals.size());
+    for (const std::vector<int> &term : primitive.m_dnf_data) {
+        m_literals.insert(m_literals.end(), term.begin(), term.end());
+        m_segment_ends.push_back(m_literals.size());
+    }
+    m_literal_offsets.push_back(m_literals.size());
+    m_segment_offsets.push_back(m_segment_ends.size());
+    m_dnf_bounds.insert(m_dnf_bounds.end(), primitive.m_dnf_offsets.begin(), primitive.m_dnf_offsets.end());
+    m_dnf_bound_offsets.push_back(m_dnf_bounds.size());
+
+    // sorted support without duplicates
+    int support_start = m_support.size();
+    for (int i = m_literal_offsets[id]; i < m_literal_offsets[id + 1]; i++) {
+        m_support.push_back(std::abs(m_literals[i]));
+    }
+    std::sort(m_support.begin() + support_start, m_support.end());
+    m_support.erase(std::unique(m_support.begin() + support_start, m_support.end()), m_support.end());
+    m_support_offsets.push_back(m_support.size());
+
+    return id;
+}
+
+std::vector<int> primitive_store::add_primitives(const std::vector<logic_primitive> &primitives) {
+    std::vector<int> ids;
+    ids.reserve(primitives.size());
+    for (const logic_primitive &primitive : primitives) {
+        ids.push_back(add_primitive(primitive));
+    }
+    return ids;
+}
+
+logic_primitive primitive_store::get_primitive(int id) {
+    int first_segment = m_segment_offsets[id];
+    int last_segment = m_segment_offsets[id + 1];
+    int begin = m_literal_offsets[id];
+    int end = m_segment_ends[first_segment];
+
+    logic_primitive result(m_types[id], m_tags[id], m_timesteps[id],
+                           std::vector<int>(m_literals.begin() + begin, m_literals.begin() + end));
+    for (int s = first_segment + 1; s < last_segment; s++) {
+        begin = end;
+        end = m_segment_ends[s];
+        result.m_dnf_data.push_back(std::vector<int>(m_literals.begin() + begin, m_literals.begin() + end));
+    }
+    result.m_dnf_offsets.assign(m_dnf_bounds.begin() + m_dnf_bound_offsets[id],
+                                m_dnf_bounds.begin() + m_dnf_bound_offsets[id + 1]);
+    return result;
+}
+
+std::vector<logic_primitive> primitive_store::get_primitives(const std::vector<int> &ids) {
+    std::vector<logic_primitive> result;
+    result.reserve(ids.size());
+    for (int id : ids) {
+        result.push_back(get_primitive(id));
+    }
+    return result;
+}
+}  // namespace planning_logic
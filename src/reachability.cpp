@@ -0,0 +1,144 @@
+#include "reachability.h"
+
+#include <algorithm>
+#include <climits>
+#include <queue>
+
+#include "logging.h"
+
+namespace reachability {
+
+std::vector<int> timestep_reachability::calculate_goal_distances(sas_problem &problem) {
+    operator_index &index = problem.m_index;
+    std::vector<int> distances(index.num_facts(), 0);
+
+    for (std::pair<int, int> &goal : problem.m_goal) {
+        int var = goal.first;
+        int range = problem.m_variabels[var].m_range;
+
+        // reversed edges of the domain transition graph of the variable
+        std::vector<std::vector<int>> predecessors(range);
+        for (int e = 0; e < index.m_effect_vars.size(); e++) {
+            int pre = index.m_effect_pres[e];
+            int post = index.m_effect_posts[e];
+            if (index.m_effect_vars[e] != var || pre == post) {
+                continue;
+            }
+            if (pre != -1) {
+                predecessors[post].push_back(pre);
+                continue;
+            }
+            for (int val = 0; val < range; val++) {
+                if (val != post) {
+                    predecessors[post].push_back(val);
+                }
+            }
+        }
+
+        // breadth first search from the goal value
+        std::vector<int> distance(range, INT_MAX);
+        std::queue<int> queue;
+        distance[goal.second] = 0;
+        queue.push(goal.second);
+        while (!queue.empty()) {
+            int val = queue.front();
+            queue.pop();
+            for (int pre : predecessors[val]) {
+                if (distance[pre] == INT_MAX) {
+                    distance[pre] = distance[val] + 1;
+                    queue.push(pre);
+                }
+            }
+        }
+        for (int val = 0; val < range; val++) {
+            distances[index.fact_id(var, val)] = distance[val];
+        }
+    }
+    return distances;
+}
+
+timestep_reachability::timestep_reachability(sas_problem &problem, int horizon) : m_horizon(horizon) {
+    LOG_MESSAGE(log_level::info) << "Calculating the reachable facts and operators for " << horizon << " timesteps";
+
+    operator_index &index = problem.m_index;
+    m_fact_offsets = index.m_fact_offsets;
+    int num_facts = index.num_facts();
+    int num_operators = problem.m_operators.size();
+
+    std::vector<int> distances;
+    if (horizon >= 0) {
+        distances = calculate_goal_distances(problem);
+    }
+    // a fact can only hold at t if the goal value of its variable is reachable in the remaining timesteps
+    auto is_goal_reachable = [&](int t, int fact) { return horizon < 0 || distances[fact] <= horizon - t; };
+
+    std::vector<bool> facts(num_facts, false);
+    for (int var = 0; var < problem.m_initial_state.size(); var++) {
+        int fact = index.fact_id(var, problem.m_initial_state[var]);
+        facts[fact] = is_goal_reachable(0, fact);
+    }
+    m_possible_facts.push_back(facts);
+
+    for (int t = 0; horizon < 0 || t < horizon; t++) {
+        std::vector<bool> &current = m_possible_facts.back();
+        std::vector<bool> operators(num_operators, false);
+        std::vector<bool> next(num_facts, false);
+        for (int fact = 0; fact < num_facts; fact++) {
+            next[fact] = current[fact] && is_goal_reachable(t + 1, fact);
+        }
+
+        for (int op = 0; op < num_operators; op++) {
+            bool is_possible = true;
+            for (int p = index.m_pre_offsets[op]; p < index.m_pre_offsets[op + 1] && is_possible; p++) {
+                is_possible = current[index.fact_id(index.m_pre_vars[p], index.m_pre_vals[p])];
+            }
+            for (int p = index.m_post_offsets[op]; p < index.m_post_offsets[op + 1] && is_possible; p++) {
+                is_possible = is_goal_reachable(t + 1, index.fact_id(index.m_post_vars[p], index.m_post_vals[p]));
+            }
+            if (!is_possible) {
+                continue;
+            }
+            operators[op] = true;
+            for (int p = index.m_post_offsets[op]; p < index.m_post_offsets[op + 1]; p++) {
+                next[index.fact_id(index.m_post_vars[p], index.m_post_vals[p])] = true;
+            }
+        }
+
+        m_possible_operators.push_back(operators);
+        bool is_fixpoint = next == current;
+        m_possible_facts.push_back(next);
+        if (horizon < 0 && is_fixpoint) {
+            break;
+        }
+    }
+
+    int num_possible_facts = 0, num_possible_operators = 0;
+    for (std::vector<bool> &layer : m_possible_facts) {
+        num_possible_facts += std::count(layer.begin(), layer.end(), true);
+    }
+    for (std::vector<bool> &layer : m_possible_operators) {
+        num_possible_operators += std::count(layer.begin(), layer.end(), true);
+    }
+    LOG_MESSAGE(log_level::info) << "Possible facts: " << num_possible_facts << " of "
+                                 << num_facts * m_possible_facts.size() << ", possible operators: "
+                                 << num_possible_operators << " of " << num_operators * m_possible_operators.size()
+                                 << " in " << m_possible_operators.size() << " timesteps";
+}
+
+bool timestep_reachability::is_fact_possible(int timestep, int var, int val) {
+    if (m_horizon >= 0 && timestep > m_horizon) {
+        // no information beyond the horizon
+        return true;
+    }
+    int layer = std::min(timestep, (int)m_possible_facts.size() - 1);
+    return m_possible_facts[layer][m_fact_offsets[var] + val];
+}
+
+bool timestep_reachability::is_operator_possible(int timestep, int op) {
+    if (m_possible_operators.empty() || (m_horizon >= 0 && timestep >= m_horizon)) {
+        return true;
+    }
+    int layer = std::min(timestep, (int)m_possible_operators.size() - 1);
+    return m_possible_operators[layer][op];
+}
+}  // namespace reachability
@@ -0,0 +1,148 @@
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "logging.h"
+#include "sas_parser.h"
+
+int sas_problem::add_h2_mutexes() {
+    LOG_MESSAGE(log_level::info) << "Start calculating h2 mutexes";
+    operator_index &index = m_index;
+    int num_facts = index.num_facts();
+    int num_operators = m_operators.size();
+
+    std::vector<int> fact_vars(num_facts), fact_vals(num_facts);
+    for (int var = 0; var < m_variabels.size(); var++) {
+        for (int val = 0; val < m_variabels[var].m_range; val++) {
+            fact_vars[index.fact_id(var, val)] = var;
+            fact_vals[index.fact_id(var, val)] = val;
+        }
+    }
+
+    // preconditions (including prevail conditions) and effects that change a variable as fact ids
+    std::vector<std::vector<int>> pres(num_operators), effs(num_operators);
+    for (int op = 0; op < num_operators; op++) {
+        for (std::tuple<int, int, int> &effect : m_operators[op].m_effects) {
+            int var = std::get<0>(effect);
+            if (std::get<1>(effect) != -1) {
+                pres[op].push_back(index.fact_id(var, std::get<1>(effect)));
+            }
+            if (std::get<1>(effect) != std::get<2>(effect)) {
+                effs[op].push_back(index.fact_id(var, std::get<2>(effect)));
+            }
+        }
+    }
+
+    // reachable facts and pairs of facts. A pair of two values of the same variable is never reachable
+    std::vector<bool> facts(num_facts, false);
+    std::vector<bool> pairs((size_t)num_facts * num_facts, false);
+    bool changed = false;
+    auto add_fact = [&](int f) {
+        if (!facts[f]) {
+            facts[f] = true;
+            pairs[(size_t)f * num_facts + f] = true;
+            changed = true;
+        }
+    };
+    auto add_pair = [&](int f, int g) {
+        if (!pairs[(size_t)f * num_facts + g]) {
+            pairs[(size_t)f * num_facts + g] = true;
+            pairs[(size_t)g * num_facts + f] = true;
+            changed = true;
+        }
+    };
+    auto is_pair = [&](int f, int g) { return pairs[(size_t)f * num_facts + g]; };
+
+    std::vector<int> initial_facts;
+    for (int var = 0; var < m_initial_state.size(); var++) {
+        initial_facts.push_back(index.fact_id(var, m_initial_state[var]));
+    }
+    for (int f : initial_facts) {
+        add_fact(f);
+        for (int g : initial_facts) {
+            if (f != g) {
+                add_pair(f, g);
+            }
+        }
+    }
+
+    // marks the variables changed by the current operator
+    std::vector<int> changed_by(m_variabels.size(), -1);
+    int num_iterations = 0;
+    changed = true;
+    while (changed) {
+        changed = false;
+        num_iterations++;
+        for (int op = 0; op < num_operators; op++) {
+            bool is_applicable = true;
+            for (int i = 0; i < pres[op].size() && is_applicable; i++) {
+                for (int j = i; j < pres[op].size() && is_applicable; j++) {
+                    is_applicable = is_pair(pres[op][i], pres[op][j]);
+                }
+            }
+            if (!is_applicable) {
+                continue;
+            }
+
+            for (int e : effs[op]) {
+                add_fact(e);
+                changed_by[fact_vars[e]] = op;
+            }
+            for (int i = 0; i < effs[op].size(); i++) {
+                for (int j = i + 1; j < effs[op].size(); j++) {
+                    add_pair(effs[op][i], effs[op][j]);
+                }
+            }
+
+            // a fact that is not changed by the operator and can hold together with its precondition,
+            // can hold together with its effects
+            for (int f = 0; f < num_facts; f++) {
+                if (!facts[f] || changed_by[fact_vars[f]] == op) {
+                    continue;
+                }
+                bool is_compatible = true;
+                for (int i = 0; i < pres[op].size() && is_compatible; i++) {
+                    is_compatible = is_pair(f, pres[op][i]);
+                }
+                if (!is_compatible) {
+                    continue;
+                }
+                for (int e : effs[op]) {
+                    add_pair(f, e);
+                }
+            }
+        }
+    }
+
+    // pairs that are already part of a mutex group
+    std::set<std::pair<int, int>> known;
+    for (std::vector<std::pair<int, int>> &group : m_mutex_groups) {
+        for (std::pair<int, int> &a : group) {
+            for (std::pair<int, int> &b : group) {
+                known.insert(std::make_pair(index.fact_id(a.first, a.second), index.fact_id(b.first, b.second)));
+            }
+        }
+    }
+
+    int num_mutexes = 0, num_new = 0;
+    for (int f = 0; f < num_facts; f++) {
+        for (int g = f + 1; g < num_facts; g++) {
+            if (fact_vars[f] == fact_vars[g] || !facts[f] || !facts[g] || is_pair(f, g)) {
+                continue;
+            }
+            num_mutexes++;
+            if (known.find(std::make_pair(f, g)) != known.end()) {
+                continue;
+            }
+            std::vector<std::pair<int, int>> group;
+            group.push_back(std::make_pair(fact_vars[f], fact_vals[f]));
+            group.push_back(std::make_pair(fact_vars[g], fact_vals[g]));
+            m_mutex_groups.push_back(group);
+            num_new++;
+        }
+    }
+
+    LOG_MESSAGE(log_level::info) << "Found " << num_mutexes << " h2 mutexes in " << num_iterations << " iterations. "
+                                 << num_new << " of them are not part of a mutex group of the sas file";
+    return num_new;
+}
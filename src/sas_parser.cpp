@@ -1,5 +1,6 @@
 #include "sas_parser.h"
 
+#include <algorithm>
 #include <regex>
 #include <fstream>
 #include <iostream>
@@ -10,6 +11,7 @@
 #include <vector>
 
 #include "logging.h"
+#include "thread_pool.h"
 
 int get_plan_length(std::string file_path) {
     std::ifstream infile(file_path);
@@ -29,71 +31,248 @@ int get_plan_length(std::string file_path) {
     return -1;
 }
 
-bool sas_problem::are_variables_consistent(std::vector<std::pair<int, int>> &set1,
-                                           std::vector<std::pair<int, int>> &set2) {
-    for (std::pair<int, int> var1 : set1) {
-        for (std::pair<int, int> var2 : set2) {
-            int id1, val1, id2, val2;
-            id1 = var1.first;
-            val1 = var1.second;
-            id2 = var2.first;
-            val2 = var2.second;
-
-            if (id1 == id2 && val1 != val2) {
-                return false;
+bool sas_problem::are_facts_consistent(const int *vars1, const int *vals1, int size1, const int *vars2,
+                                       const int *vals2, int size2) {
+    int i = 0, j = 0;
+    while (i < size1 && j < size2) {
+        if (vars1[i] < vars2[j]) {
+            i++;
+        } else if (vars1[i] > vars2[j]) {
+            j++;
+        } else {
+            // compare all pairs with this variable
+            int var = vars1[i];
+            int i_end = i, j_end = j;
+            while (i_end < size1 && vars1[i_end] == var) {
+                i_end++;
             }
+            while (j_end < size2 && vars2[j_end] == var) {
+                j_end++;
+            }
+            for (int a = i; a < i_end; a++) {
+                for (int b = j; b < j_end; b++) {
+                    if (vals1[a] != vals2[b]) {
+                        return false;
+                    }
+                }
+            }
+            i = i_end;
+            j = j_end;
         }
     }
     return true;
 }
 
+void sas_problem::build_operator_index() {
+    operator_index &index = m_index;
+    index = operator_index();
+
+    int num_operators = m_operators.size();
+    index.m_fact_offsets.reserve(m_variabels.size() + 1);
+    index.m_fact_offsets.push_back(0);
+    for (variable_info &var : m_variabels) {
+        index.m_fact_offsets.push_back(index.m_fact_offsets.back() + var.m_range);
+    }
+    int num_facts = index.num_facts();
+
+    // struct of arrays for the effect tuples
+    index.m_effect_offsets.reserve(num_operators + 1);
+    index.m_effect_offsets.push_back(0);
+    index.m_pre_offsets.push_back(0);
+    index.m_post_offsets.push_back(0);
+    std::vector<std::pair<int, int>> sorted;
+    for (int op = 0; op < num_operators; op++) {
+        for (std::tuple<int, int, int> &effect : m_operators[op].m_effects) {
+            index.m_effect_vars.push_back(std::get<0>(effect));
+            index.m_effect_pres.push_back(std::get<1>(effect));
+            index.m_effect_posts.push_back(std::get<2>(effect));
+        }
+        index.m_effect_offsets.push_back(index.m_effect_vars.size());
+
+        sorted.clear();
+        for (std::tuple<int, int, int> &effect : m_operators[op].m_effects) {
+            if (std::get<1>(effect) != -1) {
+                sorted.push_back(std::make_pair(std::get<0>(effect), std::get<1>(effect)));
+            }
+        }
+        std::sort(sorted.begin(), sorted.end());
+        for (std::pair<int, int> &pre : sorted) {
+            index.m_pre_vars.push_back(pre.first);
+            index.m_pre_vals.push_back(pre.second);
+        }
+        index.m_pre_offsets.push_back(index.m_pre_vars.size());
+
+        sorted.clear();
+        for (std::tuple<int, int, int> &effect : m_operators[op].m_effects) {
+            sorted.push_back(std::make_pair(std::get<0>(effect), std::get<2>(effect)));
+        }
+        std::sort(sorted.begin(), sorted.end());
+        for (std::pair<int, int> &post : sorted) {
+            index.m_post_vars.push_back(post.first);
+            index.m_post_vals.push_back(post.second);
+        }
+        index.m_post_offsets.push_back(index.m_post_vars.size());
+    }
+
+    // per fact lists. Count the entries first, then fill them in operator order
+    std::vector<int> adder_count(num_facts + 1), deleter_count(num_facts + 1), pre_user_count(num_facts + 1);
+    auto for_each_entry = [&](auto add_adder, auto add_deleter, auto add_pre_user) {
+        for (int op = 0; op < num_operators; op++) {
+            for (int e = index.m_effect_offsets[op]; e < index.m_effect_offsets[op + 1]; e++) {
+                int var = index.m_effect_vars[e];
+                int pre = index.m_effect_pres[e];
+                int post = index.m_effect_posts[e];
+                add_adder(index.fact_id(var, post), op);
+                if (pre != -1) {
+                    add_pre_user(index.fact_id(var, pre), op);
+                    if (pre != post) {
+                        add_deleter(index.fact_id(var, pre), op);
+                    }
+                } else {
+                    // without a precondition every other value may be deleted
+                    for (int val = 0; val < m_variabels[var].m_range; val++) {
+                        if (val != post) {
+                            add_deleter(index.fact_id(var, val), op);
+                        }
+                    }
+                }
+            }
+        }
+    };
+    for_each_entry([&](int fact, int) { adder_count[fact + 1]++; }, [&](int fact, int) { deleter_count[fact + 1]++; },
+                   [&](int fact, int) { pre_user_count[fact + 1]++; });
+    for (int f = 0; f < num_facts; f++) {
+        adder_count[f + 1] += adder_count[f];
+        deleter_count[f + 1] += deleter_count[f];
+        pre_user_count[f + 1] += pre_user_count[f];
+    }
+    index.m_adder_offsets = adder_count;
+    index.m_deleter_offsets = deleter_count;
+    index.m_pre_user_offsets = pre_user_count;
+    index.m_adders.resize(adder_count[num_facts]);
+    index.m_deleters.resize(deleter_count[num_facts]);
+    index.m_pre_users.resize(pre_user_count[num_facts]);
+    // the counts are reused as insert positions
+    for_each_entry([&](int fact, int op) { index.m_adders[adder_count[fact]++] = op; },
+                   [&](int fact, int op) { index.m_deleters[deleter_count[fact]++] = op; },
+                   [&](int fact, int op) { index.m_pre_users[pre_user_count[fact]++] = op; });
+
+    LOG_MESSAGE(log_level::info) << "Built operator index with " << num_facts << " facts and "
+                                 << index.m_effect_vars.size() << " effects";
+}
+
 bool sas_problem::are_operators_conflicting(int op_idx_1, int op_idx_2) {
     // operate should not clinflict with itself
     if (op_idx_1 == op_idx_2) {
         return false;
     }
 
-    operator_info op1 = m_operators[op_idx_1];
-    operator_info op2 = m_operators[op_idx_2];
-    std::vector<std::pair<int, int>> p1, e1, p2, e2;
-
-    // fill sets p1, e1
-    for (std::tuple<int, int, int> effect1 : op1.m_effects) {
-        int id, pre, eff;
-        id = std::get<0>(effect1);
-        pre = std::get<1>(effect1);
-        eff = std::get<2>(effect1);
+    operator_index &index = m_index;
+    const int *p1_vars = index.m_pre_vars.data() + index.m_pre_offsets[op_idx_1];
+    const int *p1_vals = index.m_pre_vals.data() + index.m_pre_offsets[op_idx_1];
+    int p1_size = index.m_pre_offsets[op_idx_1 + 1] - index.m_pre_offsets[op_idx_1];
+    const int *e1_vars = index.m_post_vars.data() + index.m_post_offsets[op_idx_1];
+    const int *e1_vals = index.m_post_vals.data() + index.m_post_offsets[op_idx_1];
+    int e1_size = index.m_post_offsets[op_idx_1 + 1] - index.m_post_offsets[op_idx_1];
+    const int *p2_vars = index.m_pre_vars.data() + index.m_pre_offsets[op_idx_2];
+    const int *p2_vals = index.m_pre_vals.data() + index.m_pre_offsets[op_idx_2];
+    int p2_size = index.m_pre_offsets[op_idx_2 + 1] - index.m_pre_offsets[op_idx_2];
+    const int *e2_vars = index.m_post_vars.data() + index.m_post_offsets[op_idx_2];
+    const int *e2_vals = index.m_post_vals.data() + index.m_post_offsets[op_idx_2];
+    int e2_size = index.m_post_offsets[op_idx_2 + 1] - index.m_post_offsets[op_idx_2];
+
+    // the are conflicting if one of p1&p2, e1&e2, e1&p2, e2&p1 is not consistent
+    bool are_nonconflicting = are_facts_consistent(p1_vars, p1_vals, p1_size, p2_vars, p2_vals, p2_size) &&
+                              are_facts_consistent(e1_vars, e1_vals, e1_size, e2_vars, e2_vals, e2_size) &&
+                              are_facts_consistent(e1_vars, e1_vals, e1_size, p2_vars, p2_vals, p2_size) &&
+                              are_facts_consistent(p1_vars, p1_vals, p1_size, e2_vars, e2_vals, e2_size);
+    return !are_nonconflicting;
+}
 
-        if (pre != -1) {
-            p1.push_back(std::make_pair(id, pre));
+graph::undirected_graph sas_problem::construct_action_conflic_graph(int num_threads) {
+    LOG_MESSAGE(log_level::info) << "Start building action conflict graph with " << num_threads << " threads";
+    operator_index &index = m_index;
+    int num_operators = m_operators.size();
+    int num_facts = index.num_facts();
+
+    // the values every operator has on a variable (precondition or effect), sorted by variable
+    // an operator has at most two values on a variable
+    std::vector<int> touch_offsets(num_operators + 1, 0);
+    std::vector<std::pair<int, int>> touches;
+    for (int op = 0; op < num_operators; op++) {
+        int first = touches.size();
+        for (int p = index.m_pre_offsets[op]; p < index.m_pre_offsets[op + 1]; p++) {
+            touches.push_back(std::make_pair(index.m_pre_vars[p], index.m_pre_vals[p]));
         }
-        if (eff != -1) {
-            // this case probably does not exists (but its no harm to check here)
-            e1.push_back(std::make_pair(id, eff));
+        for (int p = index.m_post_offsets[op]; p < index.m_post_offsets[op + 1]; p++) {
+            touches.push_back(std::make_pair(index.m_post_vars[p], index.m_post_vals[p]));
         }
+        std::sort(touches.begin() + first, touches.end());
+        touches.erase(std::unique(touches.begin() + first, touches.end()), touches.end());
+        touch_offsets[op + 1] = touches.size();
     }
-    // fill stes p2, e2
-    for (std::tuple<int, int, int> effect2 : op2.m_effects) {
-        int id, pre, eff;
-        id = std::get<0>(effect2);
-        pre = std::get<1>(effect2);
-        eff = std::get<2>(effect2);
 
-        if (pre != -1) {
-            p2.push_back(std::make_pair(id, pre));
-        }
-        if (eff != -1) {
-            // this case probably does not exists (but its no harm to check here)
-            e2.push_back(std::make_pair(id, eff));
+    // bucket of every fact with the operators that touch it
+    std::vector<int> bucket_offsets(num_facts + 1, 0);
+    for (std::pair<int, int> &touch : touches) {
+        bucket_offsets[index.fact_id(touch.first, touch.second) + 1]++;
+    }
+    for (int f = 0; f < num_facts; f++) {
+        bucket_offsets[f + 1] += bucket_offsets[f];
+    }
+    std::vector<int> buckets(bucket_offsets[num_facts]);
+    std::vector<int> position(bucket_offsets.begin(), bucket_offsets.end() - 1);
+    for (int op = 0; op < num_operators; op++) {
+        for (int t = touch_offsets[op]; t < touch_offsets[op + 1]; t++) {
+            buckets[position[index.fact_id(touches[t].first, touches[t].second)]++] = op;
         }
     }
-    bool are_nonconflicting = are_variables_consistent(p1, p2) && are_variables_consistent(e1, e2) &&
-                              are_variables_consistent(e1, p2) && are_variables_consistent(p1, e2);
-    return !are_nonconflicting;
+
+    // two operators conflict, if they have different values on a common variable
+    // for an operator with the single value val on var, these are the operators in the other buckets of var
+    // an operator with two values on var conflicts with every operator in the buckets of var
+    graph::undirected_graph result(num_operators);
+    thread_pool pool(num_threads);
+    int num_words = (num_operators + 63) / 64;
+    result.set_all_neighbours(pool, [&](int op, std::vector<int> &neighbours) {
+        // the conflicting operators are marked in a bitset, which removes duplicates and sorts them
+        std::vector<uint64_t> is_conflicting(num_words, 0);
+        int t = touch_offsets[op];
+        while (t < touch_offsets[op + 1]) {
+            int var = touches[t].first;
+            int skipped_val = touches[t].second;
+            t++;
+            if (t < touch_offsets[op + 1] && touches[t].first == var) {
+                skipped_val = -1;
+                t++;
+            }
+            for (int val = 0; val < m_variabels[var].m_range; val++) {
+                if (val == skipped_val) {
+                    continue;
+                }
+                int fact = index.fact_id(var, val);
+                for (int b = bucket_offsets[fact]; b < bucket_offsets[fact + 1]; b++) {
+                    is_conflicting[buckets[b] / 64] |= (uint64_t)1 << (buckets[b] % 64);
+                }
+            }
+        }
+        is_conflicting[op / 64] &= ~((uint64_t)1 << (op % 64));
+        for (int w = 0; w < num_words; w++) {
+            uint64_t word = is_conflicting[w];
+            while (word) {
+                neighbours.push_back(w * 64 + __builtin_ctzll(word));
+                word &= word - 1;
+            }
+        }
+    });
+
+    LOG_MESSAGE(log_level::info) << "Finished building action conflict graph with " << result.get_num_edges()
+                                 << " edges";
+    return result;
 }
 
-graph::undirected_graph sas_problem::construct_action_conflic_graph() {
-    LOG_MESSAGE(log_level::info) << "Start building action conflict graph";
+graph::undirected_graph sas_problem::construct_action_conflic_graph_pairwise() {
+    LOG_MESSAGE(log_level::info) << "Start building action conflict graph pairwise";
     graph::undirected_graph result(m_operators.size());
 
     for (int i = 0; i < m_operators.size(); i++) {
@@ -108,26 +287,346 @@ graph::undirected_graph sas_problem::construct_action_conflic_graph() {
     return result;
 }
 
-graph::undirected_graph sas_problem::construct_complement_action_conflic_graph() {
-    graph::undirected_graph result(m_operators.size());
+graph::undirected_graph sas_problem::construct_action_commutation_graph() {
+    LOG_MESSAGE(log_level::info) << "Start building action commutation graph";
+    operator_index &index = m_index;
+    int num_operators = m_operators.size();
 
-    for (int i = 0; i < m_operators.size(); i++) {
-        for (int j = i + 1; j < m_operators.size(); j++) {
-            if (!are_operators_conflicting(i, j)) {
-                // std::cout << "Adding " << i << "  " << j << std::endl;
-                result.add_edge(i, j);
+    // operators that read and that change each variable
+    std::vector<std::vector<int>> readers(m_variabels.size()), writers(m_variabels.size());
+    for (int op = 0; op < num_operators; op++) {
+        for (int p = index.m_pre_offsets[op]; p < index.m_pre_offsets[op + 1]; p++) {
+            readers[index.m_pre_vars[p]].push_back(op);
+        }
+        for (int eff = index.m_effect_offsets[op]; eff < index.m_effect_offsets[op + 1]; eff++) {
+            if (index.m_effect_pres[eff] != index.m_effect_posts[eff]) {
+                writers[index.m_effect_vars[eff]].push_back(op);
             }
         }
     }
 
+    graph::undirected_graph result(num_operators);
+    // dependent[op2] == op1 marks the operators that do not commute with op1
+    std::vector<int> dependent(num_operators, -1);
+    int num_edges = 0;
+    for (int op1 = 0; op1 < num_operators; op1++) {
+        dependent[op1] = op1;
+        for (int p = index.m_pre_offsets[op1]; p < index.m_pre_offsets[op1 + 1]; p++) {
+            for (int op2 : writers[index.m_pre_vars[p]]) {
+                dependent[op2] = op1;
+            }
+        }
+        for (int eff = index.m_effect_offsets[op1]; eff < index.m_effect_offsets[op1 + 1]; eff++) {
+            if (index.m_effect_pres[eff] == index.m_effect_posts[eff]) {
+                continue;
+            }
+            for (int op2 : readers[index.m_effect_vars[eff]]) {
+                dependent[op2] = op1;
+            }
+            for (int op2 : writers[index.m_effect_vars[eff]]) {
+                dependent[op2] = op1;
+            }
+        }
+        for (int op2 = op1 + 1; op2 < num_operators; op2++) {
+            if (dependent[op2] != op1) {
+                result.add_edge(op1, op2);
+                num_edges++;
+            }
+        }
+    }
+    LOG_MESSAGE(log_level::info) << "Finished building action commutation graph with " << num_edges << " edges";
     return result;
 }
 
+graph::undirected_graph sas_problem::construct_complement_action_conflic_graph(int num_threads) {
+    return construct_action_conflic_graph(num_threads).construct_complement();
+}
+
 int sas_parser::start_parsing() {
     LOG_MESSAGE(log_level::info) << "Start Parsing SAS Problem";
 
     m_sas_problem = sas_problem();  // clear sas_problem just in case someone messed with it
 
+    sas_tokenizer tokenizer;
+    if (!tokenizer.open(m_filepath)) {
+        return -1;
+    }
+
+    if (parse_sas_version(tokenizer) != 0 || parse_sas_metric(tokenizer) != 0 ||
+        parse_sas_variables(tokenizer) != 0 || parse_sas_mutex(tokenizer) != 0 ||
+        parse_sas_initial_state(tokenizer) != 0 || parse_sas_goal(tokenizer) != 0 ||
+        parse_sas_operator(tokenizer) != 0 || parse_sas_axiom(tokenizer) != 0) {
+        return -1;
+    }
+
+    LOG_MESSAGE(log_level::info) << "Finished parsing SAS problem. "
+                                 << "The problem has " << m_sas_problem.m_variabels.size() << " variables, "
+                                 << m_sas_problem.m_operators.size() << " operators, "
+                                 << m_sas_problem.m_initial_state.size() << " is the size of the initial states and "
+                                 << m_sas_problem.m_goal.size() << " is the size of the goal";
+
+    m_sas_problem.build_operator_index();
+    return 0;
+}
+
+int sas_parser::parse_sas_version(sas_tokenizer &tokenizer) {
+    int version;
+    if (!tokenizer.expect_line("begin_version")) {
+        LOG_MESSAGE(log_level::error) << "Expected begin_version";
+        return -1;
+    }
+    if (!tokenizer.next_int(version) || version != 3) {
+        LOG_MESSAGE(log_level::error) << "Not sas version 3";
+        return -1;
+    }
+    if (!tokenizer.expect_line("end_version")) {
+        LOG_MESSAGE(log_level::error) << "Expected end_verion";
+        return -1;
+    }
+
+    return 0;
+}
+
+int sas_parser::parse_sas_metric(sas_tokenizer &tokenizer) {
+    int metric;
+    if (!tokenizer.expect_line("begin_metric")) {
+        LOG_MESSAGE(log_level::error) << "expected begin_metric";
+        return -1;
+    }
+    // 1 indicates that action costs are used
+    if (!tokenizer.next_int(metric) || metric != 0) {
+        LOG_MESSAGE(log_level::warning) << "Not a unit cost problem. Treating all operator costs as 1";
+    }
+    if (!tokenizer.expect_line("end_metric")) {
+        LOG_MESSAGE(log_level::error) << "Expected end_metric";
+        return -1;
+    }
+
+    return 0;
+}
+
+int sas_parser::parse_sas_variables(sas_tokenizer &tokenizer) {
+    int num_variables;
+    if (!tokenizer.next_int(num_variables)) {
+        LOG_MESSAGE(log_level::error) << "Expected number of variables";
+        return -1;
+    }
+    m_sas_problem.m_variabels.reserve(num_variables);
+
+    for (int i = 0; i < num_variables; i++) {
+        int axiom_layer, var_range;
+
+        if (!tokenizer.expect_line("begin_variable")) {
+            LOG_MESSAGE(log_level::error) << "Expected begin_variables";
+            return -1;
+        }
+        std::string var_name(tokenizer.next_line());
+        if (!tokenizer.next_int(axiom_layer) || !tokenizer.next_int(var_range)) {
+            LOG_MESSAGE(log_level::error) << "Expected axiom layer and range of variable " << var_name;
+            return -1;
+        }
+
+        std::vector<std::string_view> symbolic_names;
+        symbolic_names.reserve(var_range);
+        for (int j = 0; j < var_range; j++) {
+            symbolic_names.push_back(m_sas_problem.m_name_pool->intern(tokenizer.next_line()));
+        }
+
+        if (!tokenizer.expect_line("end_variable")) {
+            LOG_MESSAGE(log_level::error) << "Expected end_variables";
+            return -1;
+        }
+
+        m_sas_problem.m_variabels.push_back(variable_info(var_name, var_range, symbolic_names));
+    }
+
+    return 0;
+}
+
+int sas_parser::parse_sas_mutex(sas_tokenizer &tokenizer) {
+    int num_mutexes;
+    if (!tokenizer.next_int(num_mutexes)) {
+        LOG_MESSAGE(log_level::error) << "Expected number of mutex groups";
+        return -1;
+    }
+    m_sas_problem.m_mutex_groups.reserve(num_mutexes);
+
+    for (int i = 0; i < num_mutexes; i++) {
+        int group_size;
+        std::vector<std::pair<int, int>> group;
+
+        if (!tokenizer.expect_line("begin_mutex_group")) {
+            LOG_MESSAGE(log_level::error) << "expected begin_mutex_group";
+            return -1;
+        }
+        if (!tokenizer.next_int(group_size)) {
+            LOG_MESSAGE(log_level::error) << "Expected size of mutex group";
+            return -1;
+        }
+
+        group.reserve(group_size);
+        for (int j = 0; j < group_size; j++) {
+            int var_index, var_value;
+            if (!tokenizer.next_int(var_index) || !tokenizer.next_int(var_value)) {
+                LOG_MESSAGE(log_level::error) << "Expected variable value pair in mutex group";
+                return -1;
+            }
+            group.push_back(std::make_pair(var_index, var_value));
+        }
+
+        m_sas_problem.m_mutex_groups.push_back(group);
+
+        if (!tokenizer.expect_line("end_mutex_group")) {
+            LOG_MESSAGE(log_level::error) << "expected end_mutex_group";
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int sas_parser::parse_sas_initial_state(sas_tokenizer &tokenizer) {
+    if (!tokenizer.expect_line("begin_state")) {
+        LOG_MESSAGE(log_level::error) << "Expected begin_state";
+        return -1;
+    }
+
+    m_sas_problem.m_initial_state.reserve(m_sas_problem.m_variabels.size());
+    for (int i = 0; i < m_sas_problem.m_variabels.size(); i++) {
+        int initial_state_value;
+        if (!tokenizer.next_int(initial_state_value)) {
+            LOG_MESSAGE(log_level::error) << "Expected initial value of variable " << i;
+            return -1;
+        }
+        m_sas_problem.m_initial_state.push_back(initial_state_value);
+    }
+
+    if (!tokenizer.expect_line("end_state")) {
+        LOG_MESSAGE(log_level::error) << "Expected end_state";
+        return -1;
+    }
+
+    return 0;
+}
+
+int sas_parser::parse_sas_goal(sas_tokenizer &tokenizer) {
+    int goal_size;
+    if (!tokenizer.expect_line("begin_goal")) {
+        LOG_MESSAGE(log_level::error) << "Expected begin_goal";
+        return -1;
+    }
+    if (!tokenizer.next_int(goal_size)) {
+        LOG_MESSAGE(log_level::error) << "Expected size of goal";
+        return -1;
+    }
+
+    for (int i = 0; i < goal_size; i++) {
+        int var_index, var_val;
+        if (!tokenizer.next_int(var_index) || !tokenizer.next_int(var_val)) {
+            LOG_MESSAGE(log_level::error) << "Expected variable value pair in goal";
+            return -1;
+        }
+        m_sas_problem.m_goal.push_back(std::make_pair(var_index, var_val));
+    }
+
+    if (!tokenizer.expect_line("end_goal")) {
+        LOG_MESSAGE(log_level::error) << "Expected end_goal";
+        return -1;
+    }
+
+    return 0;
+}
+
+int sas_parser::parse_sas_operator(sas_tokenizer &tokenizer) {
+    int num_operators;
+    if (!tokenizer.next_int(num_operators)) {
+        LOG_MESSAGE(log_level::error) << "Expected number of operators";
+        return -1;
+    }
+    m_sas_problem.m_operators.reserve(num_operators);
+
+    for (int i = 0; i < num_operators; i++) {
+        int num_prevail_conditions, num_effects, operator_cost;
+        std::vector<std::tuple<int, int, int>> effects;
+
+        if (!tokenizer.expect_line("begin_operator")) {
+            LOG_MESSAGE(log_level::error) << "Expected begin_operator";
+            return -1;
+        }
+        std::string operator_name(tokenizer.next_line());
+
+        // parse prevail conditions
+        if (!tokenizer.next_int(num_prevail_conditions)) {
+            LOG_MESSAGE(log_level::error) << "Expected number of prevail conditions";
+            return -1;
+        }
+        for (int j = 0; j < num_prevail_conditions; j++) {
+            int var_index, var_val;
+            if (!tokenizer.next_int(var_index) || !tokenizer.next_int(var_val)) {
+                LOG_MESSAGE(log_level::error) << "Expected prevail condition of " << operator_name;
+                return -1;
+            }
+            effects.push_back(std::make_tuple(var_index, var_val, var_val));
+        }
+
+        // parse effects
+        if (!tokenizer.next_int(num_effects)) {
+            LOG_MESSAGE(log_level::error) << "Expected number of effects";
+            return -1;
+        }
+        for (int j = 0; j < num_effects; j++) {
+            int num_effect_conditions, effect_var, effect_pre, effect_after;
+
+            if (!tokenizer.next_int(num_effect_conditions)) {
+                LOG_MESSAGE(log_level::error) << "Expected effect of " << operator_name;
+                return -1;
+            }
+            if (num_effect_conditions != 0) {
+                LOG_MESSAGE(log_level::error) << num_effect_conditions << " amount of effect conditions";
+                return -1;
+            }
+            if (!tokenizer.next_int(effect_var) || !tokenizer.next_int(effect_pre) ||
+                !tokenizer.next_int(effect_after)) {
+                LOG_MESSAGE(log_level::error) << "Expected effect of " << operator_name;
+                return -1;
+            }
+            effects.push_back(std::make_tuple(effect_var, effect_pre, effect_after));
+        }
+
+        if (!tokenizer.next_int(operator_cost)) {
+            LOG_MESSAGE(log_level::error) << "Expected operator cost of " << operator_name;
+            return -1;
+        }
+        if (!tokenizer.expect_line("end_operator")) {
+            LOG_MESSAGE(log_level::error) << "Expected end_operator";
+            return -1;
+        }
+
+        m_sas_problem.m_operators.push_back(operator_info(operator_name, effects));
+    }
+
+    return 0;
+}
+
+int sas_parser::parse_sas_axiom(sas_tokenizer &tokenizer) {
+    int num_axioms;
+    if (!tokenizer.next_int(num_axioms)) {
+        LOG_MESSAGE(log_level::error) << "Expected number of axioms";
+        return -1;
+    }
+    if (num_axioms != 0) {
+        LOG_MESSAGE(log_level::error) << num_axioms << " amount of axioms";
+        return -1;
+    }
+
+    return 0;
+}
+
+int sas_parser::start_parsing_legacy() {
+    LOG_MESSAGE(log_level::info) << "Start Parsing SAS Problem (legacy parser)";
+
+    m_sas_problem = sas_problem();  // clear sas_problem just in case someone messed with it
+
     std::ifstream infile(m_filepath);
     int error = 0;
 
@@ -170,6 +669,7 @@ int sas_parser::start_parsing() {
                                  << m_sas_problem.m_initial_state.size() << " is the size of the initial states and "
                                  << m_sas_problem.m_goal.size() << " is the size of the goal";
 
+    m_sas_problem.build_operator_index();
     return 0;
 }
 
@@ -234,7 +734,7 @@ int sas_parser::parse_sas_variables(std::ifstream &infile) {
         std::string var_name;
         int axiom_layer;
         int var_range;
-        std::vector<std::string> symbolic_names;
+        std::vector<std::string_view> symbolic_names;
 
         std::getline(infile, line);
         if (line != "begin_variable") {
@@ -251,7 +751,7 @@ int sas_parser::parse_sas_variables(std::ifstream &infile) {
 
         for (int j = 0; j < var_range; j++) {
             std::getline(infile, line);
-            symbolic_names.push_back(line);
+            symbolic_names.push_back(m_sas_problem.m_name_pool->intern(line));
         }
 
         std::getline(infile, line);
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include "logging.h"
+#include "sas_parser.h"
+
+int sas_problem::simplify(bool remove_irrelevant, bool merge_operators) {
+    LOG_MESSAGE(log_level::info) << "Start simplifying the sas problem with " << m_variabels.size() << " variables and "
+                                 << m_operators.size() << " operators";
+    int num_variables = m_variabels.size();
+    int num_operators = m_operators.size();
+
+    // relaxed forward reachability: a value is reachable if an applicable operator can set it
+    std::vector<std::vector<bool>> reached(num_variables);
+    for (int var = 0; var < num_variables; var++) {
+        reached[var] = std::vector<bool>(m_variabels[var].m_range, false);
+        reached[var][m_initial_state[var]] = true;
+    }
+    std::vector<bool> applicable(num_operators, false);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int op = 0; op < num_operators; op++) {
+            if (applicable[op]) {
+                continue;
+            }
+            bool is_applicable = true;
+            for (std::tuple<int, int, int> &effect : m_operators[op].m_effects) {
+                int pre = std::get<1>(effect);
+                is_applicable = is_applicable && (pre == -1 || reached[std::get<0>(effect)][pre]);
+            }
+            if (!is_applicable) {
+                continue;
+            }
+            applicable[op] = true;
+            changed = true;
+            for (std::tuple<int, int, int> &effect : m_operators[op].m_effects) {
+                reached[std::get<0>(effect)][std::get<2>(effect)] = true;
+            }
+        }
+    }
+    for (std::pair<int, int> &g : m_goal) {
+        if (!reached[g.first][g.second]) {
+            LOG_MESSAGE(log_level::warning) << "The goal " << m_variabels[g.first].m_name << "=" << g.second
+                                            << " is not reachable. The problem is not simplified";
+            return -1;
+        }
+    }
+
+    // new values of the reachable facts
+    std::vector<std::vector<int>> value_map(num_variables);
+    std::vector<int> new_ranges(num_variables, 0);
+    int num_removed_values = 0;
+    for (int var = 0; var < num_variables; var++) {
+        value_map[var] = std::vector<int>(m_variabels[var].m_range, -1);
+        for (int val = 0; val < m_variabels[var].m_range; val++) {
+            if (reached[var][val]) {
+                value_map[var][val] = new_ranges[var]++;
+            } else {
+                num_removed_values++;
+            }
+        }
+    }
+
+    // a variable with only one reachable value is constant. Irrelevant variables are neither part of the goal nor of
+    // a precondition. Changing them has no effect on which plans exist
+    std::vector<bool> is_relevant(num_variables, !remove_irrelevant);
+    for (std::pair<int, int> &g : m_goal) {
+        is_relevant[g.first] = true;
+    }
+    for (int op = 0; op < num_operators; op++) {
+        if (!applicable[op]) {
+            continue;
+        }
+        for (std::tuple<int, int, int> &effect : m_operators[op].m_effects) {
+            if (std::get<1>(effect) != -1) {
+                is_relevant[std::get<0>(effect)] = true;
+            }
+        }
+    }
+    std::vector<int> variable_map(num_variables, -1);
+    std::vector<variable_info> variables;
+    std::vector<int> initial_state;
+    int num_constant = 0, num_irrelevant = 0;
+    for (int var = 0; var < num_variables; var++) {
+        if (new_ranges[var] == 1) {
+            num_constant++;
+            continue;
+        }
+        if (!is_relevant[var]) {
+            num_irrelevant++;
+            continue;
+        }
+        variable_map[var] = variables.size();
+        std::vector<std::string_view> names;
+        for (int val = 0; val < m_variabels[var].m_symbolic_names.size(); val++) {
+            if (value_map[var][val] != -1) {
+                names.push_back(m_variabels[var].m_symbolic_names[val]);
+            }
+        }
+        variables.push_back(variable_info(m_variabels[var].m_name, new_ranges[var], names));
+        initial_state.push_back(value_map[var][m_initial_state[var]]);
+    }
+
+    // operators with the remapped effects. Identical operators are merged
+    std::vector<int> multiplicities = m_operator_multiplicities;
+    multiplicities.resize(num_operators, 1);
+    std::vector<operator_info> operators;
+    std::vector<int> new_multiplicities;
+    std::map<std::vector<std::tuple<int, int, int>>, int> known_operators;
+    int num_unreachable = 0, num_merged = 0;
+    for (int op = 0; op < num_operators; op++) {
+        if (!applicable[op]) {
+            num_unreachable++;
+            continue;
+        }
+        std::vector<std::tuple<int, int, int>> effects;
+        for (std::tuple<int, int, int> &effect : m_operators[op].m_effects) {
+            int var = std::get<0>(effect);
+            if (variable_map[var] == -1) {
+                continue;
+            }
+            int pre = std::get<1>(effect) == -1 ? -1 : value_map[var][std::get<1>(effect)];
+            effects.push_back(std::make_tuple(variable_map[var], pre, value_map[var][std::get<2>(effect)]));
+        }
+
+        if (merge_operators) {
+            std::vector<std::tuple<int, int, int>> key = effects;
+            std::sort(key.begin(), key.end());
+            auto known = known_operators.find(key);
+            if (known != known_operators.end()) {
+                new_multiplicities[known->second] += multiplicities[op];
+                num_merged++;
+                continue;
+            }
+            known_operators[key] = operators.size();
+        }
+        operators.push_back(operator_info(m_operators[op].m_name, effects));
+        new_multiplicities.push_back(multiplicities[op]);
+    }
+
+    std::vector<std::pair<int, int>> goal;
+    for (std::pair<int, int> &g : m_goal) {
+        if (variable_map[g.first] != -1) {
+            goal.push_back(std::make_pair(variable_map[g.first], value_map[g.first][g.second]));
+        }
+    }
+
+    // facts that can not hold are removed from the mutex groups
+    std::vector<std::vector<std::pair<int, int>>> mutex_groups;
+    for (std::vector<std::pair<int, int>> &group : m_mutex_groups) {
+        std::vector<std::pair<int, int>> new_group;
+        for (std::pair<int, int> &fact : group) {
+            if (variable_map[fact.first] != -1 && value_map[fact.first][fact.second] != -1) {
+                new_group.push_back(std::make_pair(variable_map[fact.first], value_map[fact.first][fact.second]));
+            }
+        }
+        if (new_group.size() > 1) {
+            mutex_groups.push_back(new_group);
+        }
+    }
+
+    m_variabels = variables;
+    m_initial_state = initial_state;
+    m_goal = goal;
+    m_mutex_groups = mutex_groups;
+    m_operators = operators;
+    // the multiplicities are only stored if they are needed to count the plans of the original problem
+    m_operator_multiplicities.clear();
+    if (num_merged > 0 || std::any_of(new_multiplicities.begin(), new_multiplicities.end(), [](int m) { return m > 1; })) {
+        m_operator_multiplicities = new_multiplicities;
+    }
+    build_operator_index();
+
+    LOG_MESSAGE(log_level::info) << "Removed " << num_constant << " constant and " << num_irrelevant
+                                 << " irrelevant variables and " << num_removed_values << " unreachable values";
+    LOG_MESSAGE(log_level::info) << "Removed " << num_unreachable << " unreachable operators and merged " << num_merged
+                                 << " duplicate operators";
+    LOG_MESSAGE(log_level::info) << "Simplified problem has " << m_variabels.size() << " variables and "
+                                 << m_operators.size() << " operators";
+    return 0;
+}
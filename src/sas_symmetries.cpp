@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "logging.h"
+#include "sas_parser.h"
+
+namespace {
+
+bool is_name_character(char c) { return std::isalnum((unsigned char)c) || c == '-' || c == '_'; }
+
+// splits a name like "pick ball1 rooma left" or "Atom at(ball1, rooma)" into its identifiers
+std::vector<std::string> split_name(std::string_view name) {
+    std::vector<std::string> result;
+    int i = 0;
+    while (i < name.size()) {
+        if (!is_name_character(name[i])) {
+            i++;
+            continue;
+        }
+        int start = i;
+        while (i < name.size() && is_name_character(name[i])) {
+            i++;
+        }
+        result.push_back(std::string(name.substr(start, i - start)));
+    }
+    return result;
+}
+
+// exchanges the identifiers a and b in the name
+std::string swap_objects(std::string_view name, const std::string &a, const std::string &b) {
+    std::string result;
+    int i = 0;
+    while (i < name.size()) {
+        if (!is_name_character(name[i])) {
+            result.push_back(name[i++]);
+            continue;
+        }
+        int start = i;
+        while (i < name.size() && is_name_character(name[i])) {
+            i++;
+        }
+        std::string_view identifier = name.substr(start, i - start);
+        if (identifier == a) {
+            result += b;
+        } else if (identifier == b) {
+            result += a;
+        } else {
+            result += identifier;
+        }
+    }
+    return result;
+}
+
+// checks if exchanging two objects in all names maps the problem onto itself
+class symmetry_checker {
+   private:
+    sas_problem &m_problem;
+    // facts and operators by their name. Names that occur more than once are mapped to -1
+    std::map<std::string, std::pair<int, int>> m_facts;
+    std::map<std::string, int> m_operators;
+    std::vector<std::vector<std::tuple<int, int, int>>> m_sorted_effects;
+    std::set<std::pair<int, int>> m_goal;
+
+   public:
+    symmetry_checker(sas_problem &problem) : m_problem(problem) {
+        for (int var = 0; var < problem.m_variabels.size(); var++) {
+            for (int val = 0; val < problem.m_variabels[var].m_symbolic_names.size(); val++) {
+                std::string name(problem.m_variabels[var].m_symbolic_names[val]);
+                bool is_new = m_facts.find(name) == m_facts.end();
+                m_facts[name] = is_new ? std::make_pair(var, val) : std::make_pair(-1, -1);
+            }
+        }
+        for (int op = 0; op < problem.m_operators.size(); op++) {
+            bool is_new = m_operators.find(problem.m_operators[op].m_name) == m_operators.end();
+            m_operators[problem.m_operators[op].m_name] = is_new ? op : -1;
+            std::vector<std::tuple<int, int, int>> effects = problem.m_operators[op].m_effects;
+            std::sort(effects.begin(), effects.end());
+            m_sorted_effects.push_back(effects);
+        }
+        m_goal.insert(problem.m_goal.begin(), problem.m_goal.end());
+    }
+
+    bool has_symbolic_names() {
+        for (variable_info &variable : m_problem.m_variabels) {
+            if (variable.m_symbolic_names.size() != variable.m_range) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool is_symmetry(const std::string &a, const std::string &b) {
+        int num_variables = m_problem.m_variabels.size();
+
+        // the variables are mapped by their uniquely named values
+        std::vector<int> var_map(num_variables, -1);
+        for (int var = 0; var < num_variables; var++) {
+            for (std::string_view name : m_problem.m_variabels[var].m_symbolic_names) {
+                auto fact = m_facts.find(swap_objects(name, a, b));
+                if (fact == m_facts.end()) {
+                    return false;
+                }
+                int target = fact->second.first;
+                if (target == -1) {
+                    continue;
+                }
+                if (var_map[var] != -1 && var_map[var] != target) {
+                    return false;
+                }
+                var_map[var] = target;
+            }
+            if (var_map[var] == -1 || m_problem.m_variabels[var_map[var]].m_range != m_problem.m_variabels[var].m_range) {
+                return false;
+            }
+        }
+        std::vector<bool> is_target(num_variables, false);
+        for (int var = 0; var < num_variables; var++) {
+            if (is_target[var_map[var]]) {
+                return false;
+            }
+            is_target[var_map[var]] = true;
+        }
+
+        // values are mapped to the value of the target variable with the exchanged name
+        std::vector<std::vector<int>> val_map(num_variables);
+        for (int var = 0; var < num_variables; var++) {
+            variable_info &target = m_problem.m_variabels[var_map[var]];
+            for (std::string_view name : m_problem.m_variabels[var].m_symbolic_names) {
+                std::string swapped = swap_objects(name, a, b);
+                auto val = std::find(target.m_symbolic_names.begin(), target.m_symbolic_names.end(), swapped);
+                if (val == target.m_symbolic_names.end() || std::count(val, target.m_symbolic_names.end(), swapped) > 1) {
+                    return false;
+                }
+                val_map[var].push_back(val - target.m_symbolic_names.begin());
+            }
+        }
+
+        for (int var = 0; var < num_variables; var++) {
+            if (m_problem.m_initial_state[var_map[var]] != val_map[var][m_problem.m_initial_state[var]]) {
+                return false;
+            }
+        }
+        for (std::pair<int, int> &g : m_problem.m_goal) {
+            if (m_goal.find(std::make_pair(var_map[g.first], val_map[g.first][g.second])) == m_goal.end()) {
+                return false;
+            }
+        }
+
+        std::vector<int> &multiplicities = m_problem.m_operator_multiplicities;
+        for (int op = 0; op < m_problem.m_operators.size(); op++) {
+            auto target = m_operators.find(swap_objects(m_problem.m_operators[op].m_name, a, b));
+            if (target == m_operators.end() || target->second == -1) {
+                return false;
+            }
+            if (!multiplicities.empty() && multiplicities[op] != multiplicities[target->second]) {
+                return false;
+            }
+            std::vector<std::tuple<int, int, int>> effects;
+            for (std::tuple<int, int, int> &effect : m_problem.m_operators[op].m_effects) {
+                int var = std::get<0>(effect);
+                int pre = std::get<1>(effect) == -1 ? -1 : val_map[var][std::get<1>(effect)];
+                effects.push_back(std::make_tuple(var_map[var], pre, val_map[var][std::get<2>(effect)]));
+            }
+            std::sort(effects.begin(), effects.end());
+            if (effects != m_sorted_effects[target->second]) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+}  // namespace
+
+int sas_problem::find_symmetric_objects() {
+    LOG_MESSAGE(log_level::info) << "Start searching for symmetric objects";
+    m_object_classes.clear();
+    symmetry_checker checker(*this);
+    if (!checker.has_symbolic_names()) {
+        LOG_MESSAGE(log_level::warning) << "The variables have no symbolic names. No symmetries are searched";
+        return 0;
+    }
+
+    // the parameters of the operators are the candidates for objects
+    std::vector<std::vector<std::string>> operator_objects;
+    std::vector<std::string> candidates;
+    for (operator_info &op : m_operators) {
+        std::vector<std::string> tokens = split_name(op.m_name);
+        if (!tokens.empty()) {
+            tokens.erase(tokens.begin());
+        }
+        for (std::string &token : tokens) {
+            if (std::find(candidates.begin(), candidates.end(), token) == candidates.end()) {
+                candidates.push_back(token);
+            }
+        }
+        operator_objects.push_back(tokens);
+    }
+
+    // the transpositions of an object with every other object of its class generate all permutations of the class
+    std::vector<std::vector<std::string>> classes;
+    for (std::string &candidate : candidates) {
+        bool found = false;
+        for (int c = 0; c < classes.size() && !found; c++) {
+            if (checker.is_symmetry(classes[c][0], candidate)) {
+                classes[c].push_back(candidate);
+                found = true;
+            }
+        }
+        if (!found) {
+            classes.push_back(std::vector<std::string>(1, candidate));
+        }
+    }
+
+    std::set<std::pair<int, int>> initial_facts;
+    for (int var = 0; var < m_initial_state.size(); var++) {
+        initial_facts.insert(std::make_pair(var, m_initial_state[var]));
+    }
+    for (std::vector<std::string> &objects : classes) {
+        if (objects.size() < 2) {
+            continue;
+        }
+        object_class new_class;
+        new_class.m_objects = objects;
+        new_class.m_touching_operators.resize(objects.size());
+        // every operator may only touch one object of the class, otherwise the first touched objects are not ordered
+        bool is_exact = true;
+        for (int op = 0; op < m_operators.size() && is_exact; op++) {
+            int num_touched = 0;
+            for (int o = 0; o < objects.size(); o++) {
+                if (std::find(operator_objects[op].begin(), operator_objects[op].end(), objects[o]) !=
+                    operator_objects[op].end()) {
+                    new_class.m_touching_operators[o].push_back(op);
+                    num_touched++;
+                }
+            }
+            is_exact = num_touched <= 1;
+        }
+        // every plan has to touch every object, so that every plan has the same number of symmetric plans.
+        // This holds if the object has a goal that is false initially and is only achieved by operators touching it
+        for (int o = 0; o < objects.size() && is_exact; o++) {
+            std::vector<int> &touching = new_class.m_touching_operators[o];
+            bool is_needed = false;
+            for (std::pair<int, int> &g : m_goal) {
+                if (initial_facts.find(g) != initial_facts.end()) {
+                    continue;
+                }
+                // operators with the goal as prevail condition can not achieve it first
+                bool only_touching = true;
+                for (const int *op = m_index.adders_begin(g.first, g.second);
+                     op != m_index.adders_end(g.first, g.second) && only_touching; op++) {
+                    only_touching = std::binary_search(touching.begin(), touching.end(), *op) ||
+                                    std::find(m_operators[*op].m_effects.begin(), m_operators[*op].m_effects.end(),
+                                              std::make_tuple(g.first, g.second, g.second)) !=
+                                        m_operators[*op].m_effects.end();
+                }
+                is_needed = is_needed || only_touching;
+            }
+            is_exact = is_needed;
+        }
+        std::string names;
+        for (std::string &object : objects) {
+            names += " " + object;
+        }
+        if (!is_exact) {
+            LOG_MESSAGE(log_level::info) << "Symmetric objects" << names
+                                         << " are not used, not all plans have the same number of symmetric plans";
+            continue;
+        }
+        LOG_MESSAGE(log_level::info) << "Found symmetric objects:" << names;
+        m_object_classes.push_back(new_class);
+    }
+
+    LOG_MESSAGE(log_level::info) << "Found " << m_object_classes.size() << " classes of symmetric objects. Every plan "
+                                 << "stands for " << symmetry_factor() << " symmetric plans";
+    return m_object_classes.size();
+}
+
+double sas_problem::symmetry_factor() {
+    double result = 1;
+    for (object_class &objects : m_object_classes) {
+        for (int i = 2; i <= objects.m_objects.size(); i++) {
+            result *= i;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,143 @@
+#include "sas_tokenizer.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "logging.h"
+
+std::string_view string_pool::intern(std::string_view str) {
+    auto it = m_lookup.find(str);
+    if (it != m_lookup.end()) {
+        return it->second;
+    }
+    // a deque never moves its elements, so views into the stored strings stay valid
+    m_storage.emplace_back(str);
+    std::string_view stored = m_storage.back();
+    m_lookup[stored] = stored;
+    return stored;
+}
+
+sas_tokenizer::~sas_tokenizer() {
+    if (m_mapping != nullptr) {
+        munmap(m_mapping, m_mapping_size);
+    }
+}
+
+bool sas_tokenizer::read_file_descriptor(int fd) {
+    const size_t chunk_size = 1 << 16;
+    size_t used = 0;
+    while (true) {
+        m_buffer.resize(used + chunk_size);
+        ssize_t num_read = read(fd, m_buffer.data() + used, chunk_size);
+        if (num_read < 0) {
+            return false;
+        }
+        if (num_read == 0) {
+            break;
+        }
+        used += num_read;
+    }
+    m_buffer.resize(used);
+
+    m_begin = m_buffer.data();
+    m_cursor = m_begin;
+    m_end = m_begin + used;
+    return true;
+}
+
+bool sas_tokenizer::open(const std::string &file_path) {
+    if (file_path == "-") {
+        LOG_MESSAGE(log_level::info) << "Reading sas problem from stdin";
+        return read_file_descriptor(STDIN_FILENO);
+    }
+
+    int fd = ::open(file_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG_MESSAGE(log_level::error) << "Could not open " << file_path;
+        return false;
+    }
+
+    struct stat file_stat;
+    bool success;
+    if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0) {
+        void *mapping = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            madvise(mapping, file_stat.st_size, MADV_SEQUENTIAL);
+            m_mapping = mapping;
+            m_mapping_size = file_stat.st_size;
+            m_begin = static_cast<const char *>(mapping);
+            m_cursor = m_begin;
+            m_end = m_begin + m_mapping_size;
+            success = true;
+        } else {
+            success = read_file_descriptor(fd);
+        }
+    } else {
+        // named pipes and other special files can not be mapped
+        success = read_file_descriptor(fd);
+    }
+    close(fd);
+
+    if (!success) {
+        LOG_MESSAGE(log_level::error) << "Could not read " << file_path;
+    }
+    return success;
+}
+
+bool sas_tokenizer::at_end() { return m_cursor >= m_end; }
+
+std::string_view sas_tokenizer::next_line() {
+    // skip what is left of the line of the last integer
+    if (m_inside_line) {
+        while (m_cursor < m_end && *m_cursor != '\n') {
+            m_cursor++;
+        }
+        if (m_cursor < m_end) {
+            m_cursor++;
+        }
+        m_inside_line = false;
+    }
+
+    const char *line_begin = m_cursor;
+    while (m_cursor < m_end && *m_cursor != '\n') {
+        m_cursor++;
+    }
+    const char *line_end = m_cursor;
+    if (m_cursor < m_end) {
+        m_cursor++;
+    }
+    // files written on windows
+    if (line_end > line_begin && *(line_end - 1) == '\r') {
+        line_end--;
+    }
+
+    return std::string_view(line_begin, line_end - line_begin);
+}
+
+bool sas_tokenizer::next_int(int &value) {
+    while (m_cursor < m_end && (*m_cursor == ' ' || *m_cursor == '\t' || *m_cursor == '\r' || *m_cursor == '\n')) {
+        m_cursor++;
+    }
+
+    bool negative = false;
+    if (m_cursor < m_end && *m_cursor == '-') {
+        negative = true;
+        m_cursor++;
+    }
+    if (m_cursor >= m_end || *m_cursor < '0' || *m_cursor > '9') {
+        return false;
+    }
+
+    int result = 0;
+    while (m_cursor < m_end && *m_cursor >= '0' && *m_cursor <= '9') {
+        result = result * 10 + (*m_cursor - '0');
+        m_cursor++;
+    }
+    value = negative ? -result : result;
+    m_inside_line = true;
+    return true;
+}
+
+bool sas_tokenizer::expect_line(std::string_view expected) { return next_line() == expected; }
@@ -80,6 +80,46 @@ void sdd_container::add_exactly_one_primitive(std::vector<int> &variables, int s
     LOG_MESSAGE(log_level::error) << "Exactly one constraint not supported for SDDs.";
     return;
 }
+void sdd_container::add_at_most_one_primitive(std::vector<int> &literals, int sdd_index) {
+    // none_true: none of the literals so far is true
+    // at_most_one_true: at most one of the literals so far is true
+    SddNode *none_true = sdd_manager_true(m_sdd_manager);
+    sdd_ref(none_true, m_sdd_manager);
+    SddNode *at_most_one_true = sdd_manager_true(m_sdd_manager);
+    sdd_ref(at_most_one_true, m_sdd_manager);
+
+    for (int i = 0; i < literals.size(); i++) {
+        SddNode *literal = sdd_manager_literal(literals[i], m_sdd_manager);
+        SddNode *not_literal = sdd_manager_literal(-literals[i], m_sdd_manager);
+
+        // (!l and at_most_one_true) or (l and none_true)
+        SddNode *keep = sdd_conjoin(not_literal, at_most_one_true, m_sdd_manager);
+        sdd_ref(keep, m_sdd_manager);
+        SddNode *first = sdd_conjoin(literal, none_true, m_sdd_manager);
+        sdd_ref(first, m_sdd_manager);
+        SddNode *new_at_most_one_true = sdd_disjoin(keep, first, m_sdd_manager);
+        sdd_ref(new_at_most_one_true, m_sdd_manager);
+        sdd_deref(keep, m_sdd_manager);
+        sdd_deref(first, m_sdd_manager);
+
+        SddNode *new_none_true = sdd_conjoin(not_literal, none_true, m_sdd_manager);
+        sdd_ref(new_none_true, m_sdd_manager);
+
+        sdd_deref(none_true, m_sdd_manager);
+        sdd_deref(at_most_one_true, m_sdd_manager);
+        none_true = new_none_true;
+        at_most_one_true = new_at_most_one_true;
+    }
+    sdd_deref(none_true, m_sdd_manager);
+
+    // conjoin the constraint with the root node
+    SddNode *tmp = sdd_conjoin(m_root_nodes[sdd_index], at_most_one_true, m_sdd_manager);
+    sdd_ref(tmp, m_sdd_manager);
+    sdd_deref(m_root_nodes[sdd_index], m_sdd_manager);
+    sdd_deref(at_most_one_true, m_sdd_manager);
+    m_root_nodes[sdd_index] = tmp;
+}
+
 void sdd_container::add_dnf_primitive(std::vector<std::vector<int>> &dnf,
                                       int sdd_index) {  // build the disjunction of the literals in the clause
     SddNode *var, *tmp;
@@ -114,6 +154,81 @@ void sdd_container::add_dnf_primitive(std::vector<std::vector<int>> &dnf,
     m_root_nodes[sdd_index] = tmp;
 }
 
+void sdd_container::add_implication_primitive(std::vector<int> &antecedent, std::vector<int> &consequent,
+                                              int sdd_index) {
+    // !antecedent is a clause
+    SddNode *implication = sdd_manager_false(m_sdd_manager);
+    sdd_ref(implication, m_sdd_manager);
+    for (int literal : antecedent) {
+        SddNode *tmp = sdd_disjoin(implication, sdd_manager_literal(-literal, m_sdd_manager), m_sdd_manager);
+        sdd_ref(tmp, m_sdd_manager);
+        sdd_deref(implication, m_sdd_manager);
+        implication = tmp;
+    }
+
+    SddNode *cube = sdd_manager_true(m_sdd_manager);
+    sdd_ref(cube, m_sdd_manager);
+    for (int literal : consequent) {
+        SddNode *tmp = sdd_conjoin(cube, sdd_manager_literal(literal, m_sdd_manager), m_sdd_manager);
+        sdd_ref(tmp, m_sdd_manager);
+        sdd_deref(cube, m_sdd_manager);
+        cube = tmp;
+    }
+
+    SddNode *tmp = sdd_disjoin(implication, cube, m_sdd_manager);
+    sdd_ref(tmp, m_sdd_manager);
+    sdd_deref(implication, m_sdd_manager);
+    sdd_deref(cube, m_sdd_manager);
+    implication = tmp;
+
+    // conjoin the implication with the root node
+    tmp = sdd_conjoin(m_root_nodes[sdd_index], implication, m_sdd_manager);
+    sdd_ref(tmp, m_sdd_manager);
+    sdd_deref(m_root_nodes[sdd_index], m_sdd_manager);
+    sdd_deref(implication, m_sdd_manager);
+    m_root_nodes[sdd_index] = tmp;
+}
+
+void sdd_container::add_transition_primitive(std::vector<std::vector<int>> &terms, std::vector<int> &dnf_offsets,
+                                             int sdd_index) {
+    SddNode *transition = sdd_manager_true(m_sdd_manager);
+    sdd_ref(transition, m_sdd_manager);
+
+    for (int d = 0; d + 1 < dnf_offsets.size(); d++) {
+        SddNode *tmp;
+        SddNode *disjunction = sdd_manager_false(m_sdd_manager);
+        sdd_ref(disjunction, m_sdd_manager);
+        for (int t = dnf_offsets[d]; t < dnf_offsets[d + 1]; t++) {
+            SddNode *conjunction = sdd_manager_true(m_sdd_manager);
+            sdd_ref(conjunction, m_sdd_manager);
+            for (int literal : terms[t]) {
+                tmp = sdd_conjoin(conjunction, sdd_manager_literal(literal, m_sdd_manager), m_sdd_manager);
+                sdd_ref(tmp, m_sdd_manager);
+                sdd_deref(conjunction, m_sdd_manager);
+                conjunction = tmp;
+            }
+            tmp = sdd_disjoin(disjunction, conjunction, m_sdd_manager);
+            sdd_ref(tmp, m_sdd_manager);
+            sdd_deref(disjunction, m_sdd_manager);
+            sdd_deref(conjunction, m_sdd_manager);
+            disjunction = tmp;
+        }
+
+        tmp = sdd_conjoin(transition, disjunction, m_sdd_manager);
+        sdd_ref(tmp, m_sdd_manager);
+        sdd_deref(transition, m_sdd_manager);
+        sdd_deref(disjunction, m_sdd_manager);
+        transition = tmp;
+    }
+
+    // conjoin the transition with the root node
+    SddNode *tmp = sdd_conjoin(m_root_nodes[sdd_index], transition, m_sdd_manager);
+    sdd_ref(tmp, m_sdd_manager);
+    sdd_deref(m_root_nodes[sdd_index], m_sdd_manager);
+    sdd_deref(transition, m_sdd_manager);
+    m_root_nodes[sdd_index] = tmp;
+}
+
 void sdd_container::create_ith_var(int i) { sdd_manager_literal(i, m_sdd_manager); }
 
 void sdd_container::set_variable_group(int low, int size){
@@ -0,0 +1,118 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+thread_pool::thread_pool(int num_threads) : m_num_pending(0), m_num_queued(0) {
+    int num_workers = std::max(num_threads, 1) - 1;
+    for (int i = 0; i <= num_workers; i++) {
+        m_queues.push_back(std::make_unique<task_queue>());
+    }
+    for (int i = 0; i < num_workers; i++) {
+        m_workers.emplace_back(&thread_pool::run_worker, this, i);
+    }
+}
+
+thread_pool::~thread_pool() {
+    {
+        std::lock_guard<std::mutex> lock(m_state_mutex);
+        m_stop = true;
+    }
+    m_work_available.notify_all();
+    for (std::thread &worker : m_workers) {
+        worker.join();
+    }
+}
+
+bool thread_pool::try_get_task(int queue_index, std::function<void()> &task) {
+    {
+        task_queue &own = *m_queues[queue_index];
+        std::lock_guard<std::mutex> lock(own.m_mutex);
+        if (!own.m_tasks.empty()) {
+            task = std::move(own.m_tasks.back());
+            own.m_tasks.pop_back();
+            m_num_queued--;
+            return true;
+        }
+    }
+    for (int i = 1; i < m_queues.size(); i++) {
+        task_queue &other = *m_queues[(queue_index + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(other.m_mutex);
+        if (!other.m_tasks.empty()) {
+            task = std::move(other.m_tasks.front());
+            other.m_tasks.pop_front();
+            m_num_queued--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void thread_pool::finish_task() {
+    if (m_num_pending.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(m_state_mutex);
+        m_work_done.notify_all();
+    }
+}
+
+void thread_pool::run_worker(int queue_index) {
+    std::function<void()> task;
+    while (true) {
+        if (try_get_task(queue_index, task)) {
+            task();
+            finish_task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_state_mutex);
+        m_work_available.wait(lock, [this] { return m_stop || m_num_queued > 0; });
+        if (m_stop) {
+            return;
+        }
+    }
+}
+
+void thread_pool::parallel_for(int n, const std::function<void(int)> &f) {
+    if (n <= 0) {
+        return;
+    }
+    if (m_workers.empty()) {
+        for (int i = 0; i < n; i++) {
+            f(i);
+        }
+        return;
+    }
+
+    // a few chunks per thread, so that threads with cheap chunks can steal from the others
+    int num_chunks = std::min(n, num_threads() * 4);
+    int chunk_size = (n + num_chunks - 1) / num_chunks;
+    num_chunks = (n + chunk_size - 1) / chunk_size;
+
+    m_num_pending += num_chunks;
+    for (int c = 0; c < num_chunks; c++) {
+        int begin = c * chunk_size;
+        int end = std::min(n, begin + chunk_size);
+        task_queue &queue = *m_queues[c % m_queues.size()];
+        std::lock_guard<std::mutex> lock(queue.m_mutex);
+        queue.m_tasks.push_back([&f, begin, end] {
+            for (int i = begin; i < end; i++) {
+                f(i);
+            }
+        });
+    }
+    m_num_queued += num_chunks;
+    {
+        std::lock_guard<std::mutex> lock(m_state_mutex);
+        m_work_available.notify_all();
+    }
+
+    // the calling thread works as well
+    int own_queue = m_queues.size() - 1;
+    std::function<void()> task;
+    while (try_get_task(own_queue, task)) {
+        task();
+        finish_task();
+    }
+
+    std::unique_lock<std::mutex> lock(m_state_mutex);
+    m_work_done.wait(lock, [this] { return m_num_pending == 0; });
+}
@@ -1,5 +1,7 @@
 #include "variable_creation.h"
 
+#include "encoder_binary_parallel.h"
+
 using namespace planning_logic;
 using namespace encoder;
 
@@ -23,7 +25,7 @@ void create_variables_for_timestep_t(int t, encoder::encoder_abstract &encoder,
         int var_domain_size = encoder.m_sas_problem.m_variabels[var].m_range;
         int var_group_small_start = encoder.m_symbol_map.next_used_index();
         int var_group_small_size;
-        if (options.binary_variables) {
+        if (encoder.is_binary_variable(var)) {
             encoder.m_symbol_map.get_variable_index_for_var_binary(t, var, 0, var_domain_size);
         } else {
             for (int val = 0; val < encoder.m_sas_problem.m_variabels[var].m_range; val++) {
@@ -48,7 +50,20 @@ void create_variables_for_timestep_t(int t, encoder::encoder_abstract &encoder,
     if (t != 0) {
         int op_group_start = encoder.m_symbol_map.next_used_index();
         int op_group_size;
-        if (options.binary_encoding) {
+        if (options.binary_parallel) {
+            // every colour class has its own binary operator variables
+            binary_parallel &parallel_encoder = dynamic_cast<binary_parallel &>(encoder);
+            for (int col = 0; col < parallel_encoder.num_colours(); col++) {
+                int col_group_start = encoder.m_symbol_map.next_used_index();
+                encoder.m_symbol_map.get_variable_index_binary(variable_plan_binary_op, t - 1, col, 0,
+                                                               parallel_encoder.colour_class_size(col));
+                container.create_ith_var(encoder.m_symbol_map.next_used_index() - 1);
+                int col_group_size = encoder.m_symbol_map.next_used_index() - col_group_start;
+                if (options.group_actions_small) {
+                    container.set_variable_group(col_group_start, col_group_size);
+                }
+            }
+        } else if (options.binary_encoding) {
             encoder.m_symbol_map.get_variable_index_for_op_binary(t - 1, 0);
         } else {
             for (int op = 0; op < encoder.m_sas_problem.m_operators.size(); op++) {